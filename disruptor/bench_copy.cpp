@@ -0,0 +1,155 @@
+#include "logger.h"
+#include "dirruptor/spmc.h"
+#include <chrono>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <vector>
+
+// 大结构体, 走non-temporal写入
+typedef struct {
+    char data[4096];
+} LargeBufferData;
+
+static constexpr size_t kItemNum = 1024 * 64;   //每种方式写入的item数量
+static constexpr size_t kBatch = 64;            //每写入一批之后扫描一次工作集
+static constexpr size_t kWorkingSet = 512 * 1024;//生产者自己的工作集, 约等于L2大小
+
+// 硬件cache miss计数, 只统计扫描工作集的部分; 没有权限或者不支持时Valid()为false
+class MissCounter {
+private:
+    int fd_ = -1;
+
+public:
+    MissCounter() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    ~MissCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool Valid() const { return fd_ >= 0; }
+
+    void Start() {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void Stop() {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    uint64_t Read() const {
+        uint64_t value = 0;
+        if (fd_ < 0 || read(fd_, &value, sizeof(value)) != sizeof(value)) {
+            return 0;
+        }
+        return value;
+    }
+};
+
+struct BenchResult {
+    double write_ns;  //每个item的写入耗时
+    double scan_ns;   //每轮扫描工作集的耗时
+    double scan_miss; //每轮扫描工作集的cache miss, 无计数时为-1
+};
+
+// 扫描工作集, 返回耗时(ns)
+static int64_t ScanWorkingSet(std::vector<char> &ws, size_t &sum) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ws.size(); i += 64) {
+        sum += ws[i];
+        ws[i] = (char) sum;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+template<typename Writer>
+static BenchResult Run(const std::string &name, const std::string &path, Writer writer) {
+    auto notebook = disruptor::Notebook<LargeBufferData>();
+    notebook.Init(path, kItemNum, true, true);
+
+    // 预先触发缺页, 避免page fault干扰计时
+    for (size_t i = 0; i < kItemNum; i++) {
+        notebook.GetData(i)->data[0] = 0;
+    }
+
+    std::vector<char> ws(kWorkingSet, 1);
+    LargeBufferData item{};
+    MissCounter counter;
+    size_t sum = 0;
+    int64_t scan_ns = 0;
+    int64_t write_ns = 0;
+    ScanWorkingSet(ws, sum);
+
+    for (size_t i = 0; i < kItemNum; i += kBatch) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < kBatch; j++) {
+            item.data[0] = (char) j;
+            writer(notebook, item);
+        }
+        auto end = std::chrono::steady_clock::now();
+        write_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        counter.Start();
+        scan_ns += ScanWorkingSet(ws, sum);
+        counter.Stop();
+    }
+
+    const size_t rounds = kItemNum / kBatch;
+    BenchResult result{(double) write_ns / kItemNum, (double) scan_ns / rounds,
+                       counter.Valid() ? (double) counter.Read() / rounds : -1};
+    SPDLOG_INFO("{}: write {:.1f} ns/item, working set scan {:.1f} ns/round, {:.0f} misses/round, sum:{}.",
+                name, result.write_ns, result.scan_ns, result.scan_miss, sum);
+    disruptor::Page(path + "_page_0.store", false).RemoveShm();
+    return result;
+}
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("bench.log", "info", false, false, false);
+    if (!init_log) {
+        return 1;
+    }
+    SPDLOG_INFO("item_size:{}, stream_threshold:{}, stream_kernel:{}.",
+                sizeof(LargeBufferData), disruptor::kStreamCopyThreshold, disruptor::kStreamCopyKernel);
+
+    // 普通memcpy, 目标slot被拉进cache
+    auto copy = Run("memcpy", "bench_memcpy", [](auto &notebook, const LargeBufferData &item) {
+        memcpy(notebook.OpenData(), &item, sizeof(LargeBufferData));
+        notebook.Commit();
+    });
+
+    // SetData, 按结构体大小选择non-temporal写入
+    auto stream = Run("stream", "bench_stream", [](auto &notebook, const LargeBufferData &item) {
+        notebook.SetData(item);
+    });
+
+    // 工作集扫描越快, miss越少, 说明写入越少地挤占生产者的cache
+    std::cout << fmt::format("kernel: {}\n", disruptor::kStreamCopyKernel);
+    std::cout << fmt::format("{:<8}{:>14}{:>14}{:>16}\n", "", "write ns/item", "scan ns/round", "scan miss/round");
+    for (auto &[name, result]: {std::pair{"memcpy", copy}, std::pair{"stream", stream}}) {
+        std::cout << fmt::format("{:<8}{:>14.1f}{:>14.1f}{:>16}\n", name, result.write_ns, result.scan_ns,
+                                 result.scan_miss < 0 ? "n/a" : fmt::format("{:.0f}", result.scan_miss));
+    }
+    std::cout << fmt::format("stream vs memcpy: write {:+.1f}%, scan {:+.1f}%",
+                             (stream.write_ns / copy.write_ns - 1) * 100, (stream.scan_ns / copy.scan_ns - 1) * 100);
+    if (copy.scan_miss > 0 && stream.scan_miss >= 0) {
+        std::cout << fmt::format(", scan misses {:+.1f}%", (stream.scan_miss / copy.scan_miss - 1) * 100);
+    }
+    std::cout << std::endl;
+    return 0;
+}
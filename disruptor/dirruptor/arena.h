@@ -0,0 +1,175 @@
+#ifndef MULTI_SHM_QUEUE_ARENA_H
+#define MULTI_SHM_QUEUE_ARENA_H
+
+#include "spmc.h"
+#include <atomic>
+
+
+namespace disruptor {
+    // 大块数据在arena中的位置, 通过Notebook传递, 读取方用Arena::Get取得数据
+    struct Blob {
+        uint64_t offset;//数据在arena中的偏移
+        uint64_t length;//数据长度
+    };
+
+    // arena开头的书签, 数据区从第一个系统页之后开始
+    struct ArenaMark {
+        Header header;           //描述信息
+        std::atomic<size_t> head;//最早未回收的位置, 单调递增
+        std::atomic<size_t> tail;//下次分配的位置, 单调递增
+    };
+
+    // 共享内存大块数据分配器, 一写多读, 按环形顺序分配
+    // 每块数据前有一个BlobHeader记录对应的Notebook位置, 所有消费者的位置越过它之后即可回收
+    // 回收信息全部在共享内存中, 生产者重启之后可以继续回收
+    class Arena {
+        struct BlobHeader {
+            uint64_t sequence;//对应的Notebook位置
+            uint64_t length;  //包括BlobHeader在内的长度
+        };
+
+        static constexpr size_t kMarkSize = 4096;
+        static constexpr size_t kAlign = 64;
+        static constexpr uint64_t kPending = -1;//已分配未提交
+        static constexpr uint64_t kPadding = -2;//环形末尾的空隙
+
+    private:
+        ArenaMark *mark_ = nullptr;
+        char *data_ = nullptr;
+        size_t capacity_ = 0;//数据区大小
+
+        static size_t Need(const size_t &length) {
+            return (sizeof(BlobHeader) + length + kAlign - 1) / kAlign * kAlign;
+        }
+
+        BlobHeader *HeaderAt(const size_t &position) const {
+            return (BlobHeader *) (data_ + position % capacity_);
+        }
+
+    public:
+        Arena() = default;
+        ~Arena() = default;
+
+        // size为整个arena文件大小, 包括书签
+        bool Init(const std::string &folder_path, const size_t &size, const bool &writer, const bool &init) {
+            if (size <= kMarkSize || size % kAlign != 0) {
+                SPDLOG_ERROR("Bad arena size: {}.", size);
+                return false;
+            }
+            auto page = Page(folder_path + "_arena.store", writer, size);
+            if (!page.GetShm()) {
+                return false;
+            }
+            mark_ = (ArenaMark *) page.GetShmDataAddress();
+            data_ = (char *) page.GetShmDataAddress() + kMarkSize;
+            capacity_ = size - kMarkSize;
+
+            Header expected{};
+            expected.magic = kMagic;
+            expected.version = kLayoutVersion;
+            expected.layout = 4;
+            expected.item_size = 1;
+            expected.type_hash = TypeHash<Blob>();
+            expected.item_num = capacity_;
+            expected.page_size = size;
+            expected.page_num = 1;
+            expected.mark_size = kMarkSize;
+            expected.create_time = NowNanos();
+            if (init) {
+                mark_->header = expected;
+                mark_->head.store(0);
+                mark_->tail.store(0);
+            } else if (!CheckHeader(mark_->header, expected)) {
+                return false;
+            }
+            return true;
+        }
+
+        // 分配length字节, 空间不足返回nullptr; 提交前数据不会被回收
+        char *Allocate(const size_t &length, Blob &blob) {
+            const size_t need = Need(length);
+            size_t tail = mark_->tail.load(std::memory_order_relaxed);
+            const size_t head = mark_->head.load(std::memory_order_relaxed);
+            const size_t offset = tail % capacity_;
+            const size_t padding = offset + need > capacity_ ? capacity_ - offset : 0;
+            if (need > capacity_ || tail + padding + need - head > capacity_) {
+                return nullptr;
+            }
+
+            // 环形末尾放不下, 剩余部分标记为空隙, 从头开始分配
+            if (padding > 0) {
+                auto gap = HeaderAt(tail);
+                gap->sequence = kPadding;
+                gap->length = padding;
+                tail += padding;
+            }
+
+            auto header = HeaderAt(tail);
+            header->sequence = kPending;
+            header->length = need;
+            blob.offset = tail % capacity_ + sizeof(BlobHeader);
+            blob.length = length;
+            mark_->tail.store(tail + need, std::memory_order_relaxed);
+            return data_ + blob.offset;
+        }
+
+        // 提交, sequence为传递这个Blob的Notebook位置
+        void Commit(const Blob &blob, const size_t &sequence) {
+            auto header = (BlobHeader *) (data_ + blob.offset - sizeof(BlobHeader));
+            header->sequence = sequence;
+        }
+
+        // 回收所有位置小于min_sequence的数据, 遇到未提交的数据停止
+        size_t Reclaim(const size_t &min_sequence) {
+            size_t head = mark_->head.load(std::memory_order_relaxed);
+            const size_t tail = mark_->tail.load(std::memory_order_relaxed);
+            size_t reclaimed = 0;
+            while (head < tail) {
+                auto header = HeaderAt(head);
+                if (header->sequence != kPadding && (header->sequence == kPending || header->sequence >= min_sequence)) {
+                    break;
+                }
+                head += header->length;
+                reclaimed += header->length;
+            }
+            mark_->head.store(head, std::memory_order_release);
+            return reclaimed;
+        }
+
+        // 分配, 空间不足时按notebook中所有存活消费者的最小位置回收, 仍然不足则等待
+        template<typename Notebook>
+        char *Allocate(const size_t &length, Blob &blob, Notebook &notebook) {
+            int nCounter = 100;
+            while (true) {
+                if (auto data = Allocate(length, blob); data != nullptr) {
+                    return data;
+                }
+                if (Reclaim(notebook.MinConsumerPosition()) > 0) {
+                    continue;
+                }
+                if (Need(length) > capacity_) {
+                    SPDLOG_ERROR("Blob too large: {}, capacity: {}.", length, capacity_);
+                    return nullptr;
+                }
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        //consumer
+        const char *Get(const Blob &blob) const {
+            return data_ + blob.offset;
+        }
+
+        // 已使用的字节数
+        size_t Used() const {
+            return mark_->tail.load(std::memory_order_relaxed) - mark_->head.load(std::memory_order_relaxed);
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_ARENA_H
@@ -0,0 +1,138 @@
+#ifndef MULTI_SHM_QUEUE_CHECKSUM_H
+#define MULTI_SHM_QUEUE_CHECKSUM_H
+
+#include "spmc.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+
+namespace disruptor {
+    // CRC32C(Castagnoli), 软件实现用查表
+    inline constexpr std::array<uint32_t, 256> kCrc32cTable = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; j++) {
+                crc = crc & 1 ? (crc >> 1) ^ 0x82f63b78 : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    inline uint32_t Crc32cSoftware(const void *data, size_t length, uint32_t crc) {
+        auto p = (const uint8_t *) data;
+        while (length--) {
+            crc = kCrc32cTable[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#if defined(__x86_64__)
+    // SSE4.2 crc32指令, 每次8字节
+    __attribute__((target("sse4.2"))) inline uint32_t Crc32cHardware(const void *data, size_t length, uint32_t crc) {
+        auto p = (const uint8_t *) data;
+        uint64_t crc64 = crc;
+        for (; length >= 8; length -= 8, p += 8) {
+            uint64_t word;
+            memcpy(&word, p, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = (uint32_t) crc64;
+        for (; length > 0; length--, p++) {
+            crc = _mm_crc32_u8(crc, *p);
+        }
+        return crc;
+    }
+#endif
+
+    // 计算CRC32C, crc为之前数据的结果, 可以分段计算; 支持SSE4.2时使用crc32指令
+    inline uint32_t Crc32c(const void *data, const size_t &length, const uint32_t &crc = 0) {
+#if defined(__SSE4_2__)
+        return ~Crc32cHardware(data, length, ~crc);
+#elif defined(__x86_64__)
+        static const bool hardware = __builtin_cpu_supports("sse4.2");
+        return ~(hardware ? Crc32cHardware(data, length, ~crc) : Crc32cSoftware(data, length, ~crc));
+#else
+        return ~Crc32cSoftware(data, length, ~crc);
+#endif
+    }
+
+    // 校验文件大小, 每个位置4字节, 按4KB对齐
+    inline size_t ChecksumFileSize(const size_t &item_num) {
+        return (item_num * sizeof(uint32_t) + 4 * Page::KB - 1) / (4 * Page::KB) * (4 * Page::KB);
+    }
+
+    // 每个位置带CRC32C的Notebook, 校验值保存在folder_path_crc.store中, 与page文件一起持久化
+    // 写入方在提交前写入校验值, 读取方和离线工具notebook_verify据此校验page文件是否完整
+    template<typename T, size_t Capacity = 0, size_t PageSize = Page::page_size>
+    class ChecksumNotebook {
+    private:
+        Notebook<T, Capacity, PageSize> notebook_;
+        uint32_t *checksums_ = nullptr;//每个位置的校验值
+
+        // 校验文件大小按书签中的容量计算, 与调用方传入的item_num无关
+        bool MapChecksums(const std::string &folder_path, const bool &writer) {
+            auto page = Page(folder_path + "_crc.store", writer, ChecksumFileSize(notebook_.GetHeader().item_num));
+            if (!page.GetShm()) {
+                return false;
+            }
+            checksums_ = (uint32_t *) page.GetShmDataAddress();
+            return true;
+        }
+
+    public:
+        ChecksumNotebook() = default;
+        ~ChecksumNotebook() = default;
+
+        bool Init(const std::string &folder_path, const size_t &item_num, const bool &writer, const bool &init) {
+            return notebook_.Init(folder_path, item_num, writer, init) && MapChecksums(folder_path, writer);
+        }
+
+        // 只根据路径加载已经init过的ChecksumNotebook, 读取方不需要知道写入方的item_num
+        bool Attach(const std::string &folder_path, const bool &writer = false) {
+            return notebook_.Attach(folder_path, writer) && MapChecksums(folder_path, writer);
+        }
+
+        //producer
+        void SetData(const T &data) {
+            const size_t idx = notebook_.GetCursor();
+            CopyItem<sizeof(T)>(notebook_.OpenData(), &data);
+            checksums_[idx] = Crc32c(&data, sizeof(T));
+            notebook_.Commit();
+        }
+
+        T *OpenData() {
+            return notebook_.OpenData();
+        }
+
+        void Commit() {
+            checksums_[notebook_.GetCursor()] = Crc32c(notebook_.OpenData(), sizeof(T));
+            notebook_.Commit();
+        }
+
+        //consumer
+        size_t WaitFor(const size_t &idx) {
+            return notebook_.WaitFor(idx);
+        }
+
+        T *GetData(const size_t &idx) {
+            return notebook_.GetData(idx);
+        }
+
+        // 校验已提交的位置
+        bool Verify(const size_t &idx) {
+            return Crc32c(notebook_.GetData(idx), sizeof(T)) == checksums_[idx];
+        }
+
+        Notebook<T, Capacity, PageSize> &GetNotebook() {
+            return notebook_;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_CHECKSUM_H
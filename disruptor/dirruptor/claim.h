@@ -0,0 +1,193 @@
+#ifndef MULTI_SHM_QUEUE_CLAIM_H
+#define MULTI_SHM_QUEUE_CLAIM_H
+
+#include "spdlog/spdlog.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace disruptor {
+    // Book中存储的类型
+    template<typename Book>
+    using ItemOf = std::remove_pointer_t<decltype(std::declval<Book &>().GetData(0))>;
+
+    // 多写入方的Notebook需要先申请位置, 例如atomic_disruptor::Notebook
+    template<typename Book>
+    constexpr bool kMultiProducer = requires(Book &book) { book.ClaimIndex(); };
+
+    // 生产者申请一个位置, 在slot中直接写入, 离开作用域时自动提交, 不会因为漏掉Commit卡住后面的位置
+    // Book可以是disruptor::Notebook或者atomic_disruptor::Notebook
+    template<typename Book>
+    class Claim {
+    public:
+        using T = ItemOf<Book>;
+
+    private:
+        Book *book_ = nullptr;
+        size_t idx_ = 0;
+        T *data_ = nullptr;
+
+    public:
+        explicit Claim(Book &book) : book_(&book) {
+            if constexpr (kMultiProducer<Book>) {
+                idx_ = book.ClaimIndex();
+                if (idx_ == Book::kNoIndex) {
+                    book_ = nullptr;
+                    return;
+                }
+                data_ = book.OpenData(idx_);
+            } else {
+                idx_ = book.GetCursor();
+                data_ = book.OpenData();
+            }
+        }
+
+        Claim(Claim &&other) noexcept
+            : book_(std::exchange(other.book_, nullptr)), idx_(other.idx_), data_(other.data_) {}
+        Claim(const Claim &) = delete;
+        Claim &operator=(const Claim &) = delete;
+        Claim &operator=(Claim &&) = delete;
+
+        ~Claim() {
+            Commit();
+        }
+
+        // 提前提交, 之后不能再写入
+        void Commit() {
+            if (book_ == nullptr) {
+                return;
+            }
+            if constexpr (kMultiProducer<Book>) {
+                book_->Commit(idx_);
+            } else {
+                book_->Commit();
+            }
+            book_ = nullptr;
+        }
+
+        // 放弃写入; 多写入方申请的位置必须提交, 否则后面的位置都无法提交, 所以只有单写入方可以放弃
+        void Cancel() requires(!kMultiProducer<Book>) {
+            book_ = nullptr;
+        }
+
+        // 多写入方申请失败时无效, 不能写入
+        bool Valid() const {
+            return data_ != nullptr;
+        }
+
+        size_t Index() const {
+            return idx_;
+        }
+
+        T *Get() const {
+            return data_;
+        }
+
+        T *operator->() const {
+            return data_;
+        }
+
+        T &operator*() const {
+            return *data_;
+        }
+    };
+
+    // 在申请的slot中用args直接构造T, 不需要先在栈上构造再拷贝
+    template<typename Book, typename... Args>
+    Claim<Book> Emplace(Book &book, Args &&...args) {
+        Claim<Book> claim(book);
+        new (claim.Get()) ItemOf<Book>{std::forward<Args>(args)...};
+        return claim;
+    }
+
+    // 一次申请连续的n个位置, 离开作用域时一起提交; 多写入方只在申请和提交时各竞争一次
+    // n为0时是空的批次, 不申请也不提交; n超过容量时会覆盖还没有读取的位置, 记录错误并返回空的批次
+    // 空的批次Size()为0, 调用方按Size()写入
+    template<typename Book>
+    class BatchClaim {
+    public:
+        using T = ItemOf<Book>;
+
+    private:
+        Book *book_ = nullptr;
+        size_t first_ = 0;
+        size_t num_ = 0;
+
+    public:
+        BatchClaim(Book &book, const size_t &n) : book_(&book), num_(n) {
+            if (n == 0 || n > book.GetHeader().item_num) {
+                if (n > 0) {
+                    SPDLOG_ERROR("Batch size {} exceeds item num {}.", n, book.GetHeader().item_num);
+                }
+                book_ = nullptr;
+                num_ = 0;
+                return;
+            }
+            if constexpr (kMultiProducer<Book>) {
+                first_ = book.ClaimIndex((uint32_t) n);
+                if (first_ == Book::kNoIndex) {
+                    book_ = nullptr;
+                    num_ = 0;
+                }
+            } else {
+                first_ = book.GetCursor();
+            }
+        }
+
+        BatchClaim(BatchClaim &&other) noexcept
+            : book_(std::exchange(other.book_, nullptr)), first_(other.first_), num_(other.num_) {}
+        BatchClaim(const BatchClaim &) = delete;
+        BatchClaim &operator=(const BatchClaim &) = delete;
+        BatchClaim &operator=(BatchClaim &&) = delete;
+
+        ~BatchClaim() {
+            Commit();
+        }
+
+        void Commit() {
+            if (book_ == nullptr) {
+                return;
+            }
+            if constexpr (kMultiProducer<Book>) {
+                book_->CommitBatch(first_, num_);
+            } else {
+                book_->CommitBatch(num_);
+            }
+            book_ = nullptr;
+        }
+
+        void Cancel() requires(!kMultiProducer<Book>) {
+            book_ = nullptr;
+        }
+
+        // 第一个位置的序号
+        size_t First() const {
+            return first_;
+        }
+
+        size_t Size() const {
+            return num_;
+        }
+
+        // 批内第i个slot, 可能跨页, 每次按序号取地址
+        T *Get(const size_t &i) const {
+            assert(i < num_);
+            return book_->GetData(first_ + i);
+        }
+
+        T *operator[](const size_t &i) const {
+            return Get(i);
+        }
+
+        template<typename... Args>
+        T *Emplace(const size_t &i, Args &&...args) {
+            return new (Get(i)) T{std::forward<Args>(args)...};
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_CLAIM_H
@@ -0,0 +1,84 @@
+#ifndef MULTI_SHM_QUEUE_CONFLATE_H
+#define MULTI_SHM_QUEUE_CONFLATE_H
+
+#include "spmc.h"
+#include <atomic>
+
+
+namespace disruptor {
+    // 按key合并的Notebook, 消息照常顺序写入
+    // 生产者在提交前记录每个key最新消息的位置, 消费者读到的消息如果已经有同key的更新消息就跳过
+    // 慢消费者因此只处理每个key的最新状态; 不改写已提交的slot, 避免和正在读取的消费者冲突
+    // KeyOf(data)返回[0, key_num)之间的key, 超出范围的消息不合并
+    template<typename T, typename KeyOf, size_t Capacity = 0, size_t PageSize = Page::page_size>
+    class ConflatingNotebook {
+    private:
+        Notebook<T, Capacity, PageSize> notebook_;
+        std::atomic<size_t> *latest_ = nullptr;//每个key最新消息的位置加1, 0表示没有
+        size_t key_num_ = 0;
+        size_t skipped_ = 0;//消费者跳过的消息数量
+
+    public:
+        ConflatingNotebook() = default;
+        ~ConflatingNotebook() = default;
+
+        bool Init(const std::string &folder_path, const size_t &item_num, const size_t &key_num, const bool &writer, const bool &init) {
+            if (!notebook_.Init(folder_path, item_num, writer, init)) {
+                return false;
+            }
+
+            const size_t size = (key_num * sizeof(size_t) + 4 * Page::KB - 1) / (4 * Page::KB) * (4 * Page::KB);
+            auto page = Page(folder_path + "_keys.store", writer, size);
+            if (!page.GetShm()) {
+                return false;
+            }
+            latest_ = (std::atomic<size_t> *) page.GetShmDataAddress();
+            key_num_ = key_num;
+            if (init) {
+                for (size_t key = 0; key < key_num; key++) {
+                    latest_[key].store(0);
+                }
+            }
+            return true;
+        }
+
+        // 生产者, 先记录key的最新位置再提交, 消费者看到这条消息时一定能看到它的位置
+        void SetData(const T &data) {
+            const size_t idx = notebook_.GetCursor();
+            CopyItem<sizeof(T)>(notebook_.OpenData(), &data);
+            const size_t key = KeyOf{}(data);
+            if (key < key_num_) {
+                latest_[key].store(idx + 1, std::memory_order_release);
+            }
+            notebook_.Commit();
+        }
+
+        // 消费者, 批量读取[begin, end), 只对同key中最新的消息调用handler
+        template<typename Func>
+        size_t ForEach(const size_t &begin, const size_t &end, Func &&handler) {
+            return notebook_.ForEach(begin, end, [this, &handler](const size_t &idx, T *data) {
+                const size_t key = KeyOf{}(*data);
+                if (key < key_num_ && latest_[key].load(std::memory_order_acquire) > idx + 1) {
+                    skipped_++;
+                    return;
+                }
+                handler(idx, data);
+            });
+        }
+
+        size_t WaitFor(const size_t &idx) {
+            return notebook_.WaitFor(idx);
+        }
+
+        // 消费者跳过的消息数量
+        size_t Skipped() const {
+            return skipped_;
+        }
+
+        Notebook<T, Capacity, PageSize> &GetNotebook() {
+            return notebook_;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_CONFLATE_H
@@ -0,0 +1,82 @@
+#ifndef MULTI_SHM_QUEUE_COPY_H
+#define MULTI_SHM_QUEUE_COPY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+namespace disruptor {
+    // 结构体大于等于该阈值时使用non-temporal写入, 避免目标slot挤占生产者的cache
+    static constexpr size_t kStreamCopyThreshold = 1024;
+
+    // 编译期选定的non-temporal写入宽度, 由编译参数决定:
+    // 默认的x86-64编译只有SSE2, 使用16字节写入; -mavx2(或-mavx)使用32字节, -mavx512f使用64字节;
+    // CMake中打开DISRUPTOR_NATIVE_ARCH即按本机支持的最宽指令编译. 非x86平台退回memcpy
+#if defined(__AVX512F__)
+    static constexpr const char *kStreamCopyKernel = "avx512, 64 bytes";
+#elif defined(__AVX__)
+    static constexpr const char *kStreamCopyKernel = "avx, 32 bytes";
+#elif defined(__SSE2__)
+    static constexpr const char *kStreamCopyKernel = "sse2, 16 bytes";
+#else
+    static constexpr const char *kStreamCopyKernel = "memcpy";
+#endif
+
+    // 非临时写入(绕过cache), 头尾未对齐部分使用普通拷贝
+    inline void StreamCopy(void *dst, const void *src, size_t n) {
+#if defined(__SSE2__)
+#if defined(__AVX512F__)
+        constexpr size_t width = 64;
+#elif defined(__AVX__)
+        constexpr size_t width = 32;
+#else
+        constexpr size_t width = 16;
+#endif
+        auto *d = (char *) dst;
+        auto *s = (const char *) src;
+
+        // 对齐目标地址
+        const size_t head = (width - ((uintptr_t) d & (width - 1))) & (width - 1);
+        if (head >= n) {
+            memcpy(d, s, n);
+            return;
+        }
+        memcpy(d, s, head);
+        d += head;
+        s += head;
+        n -= head;
+
+        for (; n >= width; n -= width, d += width, s += width) {
+#if defined(__AVX512F__)
+            _mm512_stream_si512((__m512i *) d, _mm512_loadu_si512((const void *) s));
+#elif defined(__AVX__)
+            _mm256_stream_si256((__m256i *) d, _mm256_loadu_si256((const __m256i *) s));
+#else
+            _mm_stream_si128((__m128i *) d, _mm_loadu_si128((const __m128i *) s));
+#endif
+        }
+        memcpy(d, s, n);
+
+        // non-temporal写入是弱序的, 发布cursor之前必须sfence
+        _mm_sfence();
+#else
+        memcpy(dst, src, n);
+#endif
+    }
+
+    // 根据结构体大小在编译期选择拷贝方式
+    template<size_t N>
+    inline void CopyItem(void *dst, const void *src) {
+        if constexpr (N < kStreamCopyThreshold) {
+            memcpy(dst, src, N);//定长拷贝, 编译器内联展开
+        } else {
+            StreamCopy(dst, src, N);
+        }
+    }
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_COPY_H
@@ -0,0 +1,226 @@
+#ifndef MULTI_SHM_QUEUE_CORO_H
+#define MULTI_SHM_QUEUE_CORO_H
+
+#include "spmc.h"
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+
+namespace disruptor {
+    class Executor;
+
+    // 由Executor调度的协程, 创建后挂起, Spawn之后开始执行, 执行结束由Executor销毁
+    class Task {
+    public:
+        struct promise_type {
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() {
+                SPDLOG_ERROR("Unhandled exception in task.");
+                std::terminate();
+            }
+        };
+
+        Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+    private:
+        friend class Executor;
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    // 挂起等待的条件, Executor每一轮检查一次Ready, 满足后恢复对应的协程
+    class Awaiter {
+    public:
+        virtual ~Awaiter() = default;
+        virtual bool Ready() = 0;
+
+    protected:
+        friend class Executor;
+        std::coroutine_handle<> handle_;
+    };
+
+    // 单线程执行器, 多个低频订阅共用一个线程, 由执行器轮询各个订阅的浮标, 而不是每个订阅一个线程自旋
+    class Executor {
+    private:
+        std::deque<std::coroutine_handle<>> ready_;//可以恢复的协程
+        std::vector<Awaiter *> waiting_;           //挂起等待的协程, Awaiter在协程帧中, 恢复前一直有效
+        std::vector<std::coroutine_handle<>> tasks_;//Spawn的协程, 执行结束后销毁
+        bool stop_ = false;
+
+    public:
+        Executor() = default;
+        Executor(const Executor &) = delete;
+        Executor &operator=(const Executor &) = delete;
+        ~Executor() {
+            for (auto handle: tasks_) {
+                handle.destroy();
+            }
+        }
+
+        void Spawn(Task task) {
+            auto handle = std::exchange(task.handle_, nullptr);
+            tasks_.push_back(handle);
+            ready_.push_back(handle);
+        }
+
+        void Wait(Awaiter *awaiter, std::coroutine_handle<> handle) {
+            awaiter->handle_ = handle;
+            waiting_.push_back(awaiter);
+        }
+
+        // 执行一轮: 检查所有等待的条件, 恢复可以执行的协程, 返回恢复的数量
+        size_t RunOnce() {
+            for (size_t i = 0; i < waiting_.size();) {
+                if (waiting_[i]->Ready()) {
+                    ready_.push_back(waiting_[i]->handle_);
+                    waiting_[i] = waiting_.back();
+                    waiting_.pop_back();
+                } else {
+                    i++;
+                }
+            }
+
+            size_t resumed = 0;
+            for (size_t n = ready_.size(); n > 0; n--) {
+                auto handle = ready_.front();
+                ready_.pop_front();
+                handle.resume();
+                resumed++;
+            }
+
+            std::erase_if(tasks_, [](std::coroutine_handle<> handle) {
+                if (handle.done()) {
+                    handle.destroy();
+                    return true;
+                }
+                return false;
+            });
+            return resumed;
+        }
+
+        // 执行到所有协程结束或者Stop
+        void Run() {
+            int nCounter = 100;
+            stop_ = false;
+            while (!stop_ && !tasks_.empty()) {
+                if (RunOnce() > 0) {
+                    nCounter = 100;
+                    continue;
+                }
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        void Stop() {
+            stop_ = true;
+        }
+    };
+
+    // 读取位置区间[begin, end)
+    struct Batch {
+        size_t begin;
+        size_t end;
+    };
+
+    // Notebook的协程订阅, co_await Next()读取下一条, co_await NextBatch()读取所有已写入的数据
+    // 等待时不自旋, 由Executor轮询浮标; 数据已经就绪时不挂起, 但连续yield_interval次之后挂起一次,
+    // 让出执行器, 避免一个繁忙的订阅饿死同一个执行器上的其他订阅
+    template<typename Book>
+    class Subscription {
+    private:
+        Book &notebook_;
+        Executor &executor_;
+        size_t idx_;
+        size_t yield_interval_ = 64;//连续多少次不挂起之后让出一次, 0表示每次都让出
+        size_t streak_ = 0;         //连续不挂起的次数
+
+        class NextAwaiter : public Awaiter {
+        public:
+            NextAwaiter(Subscription &subscription, const size_t &max_num) : subscription_(subscription), max_num_(max_num) {}
+
+            bool Ready() override {
+                cursor_ = subscription_.notebook_.GetCursor();
+                return subscription_.idx_ < cursor_;
+            }
+
+            bool await_ready() {
+                if (Ready() && subscription_.streak_ < subscription_.yield_interval_) {
+                    subscription_.streak_++;
+                    return true;
+                }
+                subscription_.streak_ = 0;
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                subscription_.executor_.Wait(this, handle);
+            }
+
+            Batch await_resume() {
+                const size_t begin = subscription_.idx_;
+                const size_t end = cursor_ - begin > max_num_ ? begin + max_num_ : cursor_;
+                subscription_.idx_ = end;
+                return {begin, end};
+            }
+
+        protected:
+            Subscription &subscription_;
+            size_t max_num_;
+            size_t cursor_ = 0;
+        };
+
+        class ItemAwaiter : public NextAwaiter {
+        public:
+            explicit ItemAwaiter(Subscription &subscription) : NextAwaiter(subscription, 1) {}
+
+            auto await_resume() {
+                return this->subscription_.notebook_.GetData(NextAwaiter::await_resume().begin);
+            }
+        };
+
+    public:
+        Subscription(Book &notebook, Executor &executor, const size_t &idx = 0)
+            : notebook_(notebook), executor_(executor), idx_(idx) {}
+
+        // 下一条数据
+        ItemAwaiter Next() {
+            return ItemAwaiter(*this);
+        }
+
+        // 所有已写入的数据, 最多max_num条, 配合Notebook::ForEach使用
+        NextAwaiter NextBatch(const size_t &max_num = -1) {
+            return NextAwaiter(*this, max_num);
+        }
+
+        void SetYieldInterval(const size_t &interval) {
+            yield_interval_ = interval;
+        }
+
+        // 下一个待读取的位置
+        size_t Position() const {
+            return idx_;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_CORO_H
@@ -0,0 +1,304 @@
+#ifndef MULTI_SHM_QUEUE_EXPORT_H
+#define MULTI_SHM_QUEUE_EXPORT_H
+
+#include "journal.h"
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+
+namespace disruptor {
+    static constexpr uint64_t kColumnMagic = 0x4e4d554c4f43424e;//"NBCOLUMN"
+    static constexpr uint32_t kColumnVersion = 1;
+
+    enum class ColumnType : uint32_t {
+        kInt8, kInt16, kInt32, kInt64,
+        kUInt8, kUInt16, kUInt32, kUInt64,
+        kFloat, kDouble,
+    };
+
+    inline size_t ColumnWidth(const ColumnType &type) {
+        static constexpr size_t widths[] = {1, 2, 4, 8, 1, 2, 4, 8, 4, 8};
+        return widths[(uint32_t) type];
+    }
+
+    inline bool ColumnSigned(const ColumnType &type) { return type <= ColumnType::kInt64; }
+    inline bool ColumnFloating(const ColumnType &type) { return type >= ColumnType::kFloat; }
+
+    // 列文件: ColumnFileHeader, block_num个BlockStats, 之后是各个block的数据
+    // 数值统一扩展为64位: 有符号整数为int64, 无符号整数为uint64, 浮点为double
+    // encoding为0时按原宽度连续存放; 为1时第一个值8字节, 之后为与前一个值之差的zigzag varint
+    struct ColumnFileHeader {
+        uint64_t magic;     //固定为kColumnMagic
+        uint32_t version;   //kColumnVersion
+        uint32_t type;      //ColumnType
+        uint32_t width;     //原始宽度
+        uint32_t encoding;  //0原始, 1差分
+        uint64_t item_num;  //行数
+        uint64_t block_size;//每个block的行数
+        uint64_t block_num; //block数量
+    };
+
+    // 每个block的位置和统计, min和max为64位扩展后的值, 分析时据此跳过不需要的block
+    struct BlockStats {
+        uint64_t offset;//数据在文件中的偏移
+        uint64_t length;//数据字节数
+        uint64_t count; //行数
+        uint64_t min;
+        uint64_t max;
+    };
+
+    struct ColumnSpec {
+        std::string name;
+        size_t offset;  //字段在结构体中的偏移
+        ColumnType type;
+        bool delta;     //差分编码, 适用于时间戳和序号
+    };
+
+    // 读取字段并扩展为64位
+    inline uint64_t LoadColumnValue(const char *p, const ColumnType &type) {
+        switch (type) {
+            case ColumnType::kInt8: return (int64_t) *(const int8_t *) p;
+            case ColumnType::kInt16: { int16_t v; memcpy(&v, p, 2); return (int64_t) v; }
+            case ColumnType::kInt32: { int32_t v; memcpy(&v, p, 4); return (int64_t) v; }
+            case ColumnType::kUInt8: return *(const uint8_t *) p;
+            case ColumnType::kUInt16: { uint16_t v; memcpy(&v, p, 2); return v; }
+            case ColumnType::kUInt32: { uint32_t v; memcpy(&v, p, 4); return v; }
+            case ColumnType::kFloat: { float f; memcpy(&f, p, 4); double d = f; uint64_t v; memcpy(&v, &d, 8); return v; }
+            default: { uint64_t v; memcpy(&v, p, 8); return v; }
+        }
+    }
+
+    // 按类型比较两个64位扩展后的值
+    inline bool ColumnLess(const uint64_t &a, const uint64_t &b, const ColumnType &type) {
+        if (ColumnFloating(type)) {
+            double x, y;
+            memcpy(&x, &a, 8);
+            memcpy(&y, &b, 8);
+            return x < y;
+        }
+        return ColumnSigned(type) ? (int64_t) a < (int64_t) b : a < b;
+    }
+
+    // 并行导出Notebook的page文件为列文件, 每个字段一个文件: <out_path>_<name>.col
+    // 每个线程按block读取所有字段, 每个item只读取一次
+    class ColumnExporter {
+    private:
+        std::vector<ColumnSpec> columns_;
+        size_t block_size_ = 64 * 1024;
+        size_t thread_num_ = std::max(1u, std::thread::hardware_concurrency());
+
+        // 编码一个block, 返回统计, 数据追加到buffer
+        static BlockStats EncodeBlock(const Journal &journal, const ColumnSpec &column, const size_t &begin, const size_t &end, std::vector<char> &buffer) {
+            BlockStats stats{};
+            stats.count = end - begin;
+            uint64_t previous = 0;
+            for (auto idx = begin; idx < end; idx++) {
+                const char *p = journal.Item(idx) + column.offset;
+                const uint64_t value = LoadColumnValue(p, column.type);
+                if (idx == begin || ColumnLess(value, stats.min, column.type)) {
+                    stats.min = value;
+                }
+                if (idx == begin || ColumnLess(stats.max, value, column.type)) {
+                    stats.max = value;
+                }
+
+                if (!column.delta) {
+                    buffer.insert(buffer.end(), p, p + ColumnWidth(column.type));
+                } else if (idx == begin) {
+                    buffer.insert(buffer.end(), (const char *) &value, (const char *) &value + 8);
+                } else {
+                    const int64_t diff = (int64_t) (value - previous);
+                    uint64_t zigzag = ((uint64_t) diff << 1) ^ (uint64_t) (diff >> 63);
+                    while (zigzag >= 0x80) {
+                        buffer.push_back((char) (zigzag | 0x80));
+                        zigzag >>= 7;
+                    }
+                    buffer.push_back((char) zigzag);
+                }
+                previous = value;
+            }
+            stats.length = buffer.size();
+            return stats;
+        }
+
+    public:
+        ColumnExporter() = default;
+        ~ColumnExporter() = default;
+
+        bool AddColumn(const std::string &name, const size_t &offset, const ColumnType &type, const bool &delta = false) {
+            if (delta && ColumnFloating(type)) {
+                SPDLOG_ERROR("Delta encoding requires an integer column: {}.", name);
+                return false;
+            }
+            columns_.push_back({name, offset, type, delta});
+            return true;
+        }
+
+        void SetBlockSize(const size_t &block_size) {
+            block_size_ = std::max<size_t>(block_size, 1);
+        }
+
+        void SetThreadNum(const size_t &thread_num) {
+            thread_num_ = std::max<size_t>(thread_num, 1);
+        }
+
+        // 导出[0, 已写入位置)
+        bool Export(const Journal &journal, const std::string &out_path) {
+            for (auto &column: columns_) {
+                if (column.offset + ColumnWidth(column.type) > journal.ItemSize()) {
+                    SPDLOG_ERROR("Column {} out of item, offset:{}, item_size:{}.", column.name, column.offset, journal.ItemSize());
+                    return false;
+                }
+            }
+
+            const size_t item_num = journal.GetCursor();
+            const size_t block_num = (item_num + block_size_ - 1) / block_size_;
+            std::vector<FILE *> files;
+            std::vector<std::vector<BlockStats>> stats(columns_.size(), std::vector<BlockStats>(block_num));
+            std::vector<uint64_t> offsets(columns_.size(), sizeof(ColumnFileHeader) + block_num * sizeof(BlockStats));
+            for (auto &column: columns_) {
+                const std::string path = out_path + "_" + column.name + ".col";
+                FILE *file = fopen(path.c_str(), "wb");
+                if (file == nullptr || fseek(file, (long) offsets[0], SEEK_SET) != 0) {
+                    SPDLOG_ERROR("Failed to open {}, errno: {}", path, strerror(errno));
+                    for (auto f: files) {
+                        fclose(f);
+                    }
+                    if (file != nullptr) {
+                        fclose(file);
+                    }
+                    return false;
+                }
+                files.push_back(file);
+            }
+
+            // 每轮每个线程编码若干个block, 按顺序写入, 内存占用与总行数无关
+            const size_t round_blocks = thread_num_ * 4;
+            std::vector<std::vector<char>> buffers(columns_.size() * round_blocks);
+            bool ok = true;
+            for (size_t first = 0; first < block_num && ok; first += round_blocks) {
+                const size_t last = std::min(block_num, first + round_blocks);
+                std::vector<std::thread> threads;
+                for (size_t t = 0; t < thread_num_; t++) {
+                    threads.emplace_back([&, t]() {
+                        for (auto b = first + t; b < last; b += thread_num_) {
+                            const size_t begin = b * block_size_;
+                            const size_t end = std::min(item_num, begin + block_size_);
+                            for (size_t c = 0; c < columns_.size(); c++) {
+                                auto &buffer = buffers[c * round_blocks + b - first];
+                                buffer.clear();
+                                stats[c][b] = EncodeBlock(journal, columns_[c], begin, end, buffer);
+                            }
+                        }
+                    });
+                }
+                for (auto &thread: threads) {
+                    thread.join();
+                }
+
+                for (size_t c = 0; c < columns_.size(); c++) {
+                    for (auto b = first; b < last; b++) {
+                        auto &buffer = buffers[c * round_blocks + b - first];
+                        stats[c][b].offset = offsets[c];
+                        offsets[c] += buffer.size();
+                        if (fwrite(buffer.data(), 1, buffer.size(), files[c]) != buffer.size()) {
+                            SPDLOG_ERROR("Failed to write column {}, errno: {}", columns_[c].name, strerror(errno));
+                            ok = false;
+                        }
+                    }
+                }
+            }
+
+            for (size_t c = 0; c < columns_.size(); c++) {
+                ColumnFileHeader header{};
+                header.magic = kColumnMagic;
+                header.version = kColumnVersion;
+                header.type = (uint32_t) columns_[c].type;
+                header.width = ColumnWidth(columns_[c].type);
+                header.encoding = columns_[c].delta ? 1 : 0;
+                header.item_num = item_num;
+                header.block_size = block_size_;
+                header.block_num = block_num;
+                ok = ok && fseek(files[c], 0, SEEK_SET) == 0 &&
+                     fwrite(&header, sizeof(header), 1, files[c]) == 1 &&
+                     fwrite(stats[c].data(), sizeof(BlockStats), block_num, files[c]) == block_num;
+                fclose(files[c]);
+            }
+            if (ok) {
+                SPDLOG_INFO("Export {} items, {} columns, {} blocks.", item_num, columns_.size(), block_num);
+            }
+            return ok;
+        }
+    };
+
+    // 读取列文件, 可以先根据BlockStats跳过block
+    class ColumnReader {
+    private:
+        std::vector<char> data_;
+        ColumnFileHeader header_{};
+        const BlockStats *stats_ = nullptr;
+
+    public:
+        bool Open(const std::string &path) {
+            FILE *file = fopen(path.c_str(), "rb");
+            if (file == nullptr) {
+                SPDLOG_ERROR("Failed to open {}, errno: {}", path, strerror(errno));
+                return false;
+            }
+            fseek(file, 0, SEEK_END);
+            data_.resize(ftell(file));
+            fseek(file, 0, SEEK_SET);
+            const bool ok = fread(data_.data(), 1, data_.size(), file) == data_.size();
+            fclose(file);
+            if (!ok || data_.size() < sizeof(ColumnFileHeader)) {
+                SPDLOG_ERROR("Failed to read {}.", path);
+                return false;
+            }
+            memcpy(&header_, data_.data(), sizeof(header_));
+            if (header_.magic != kColumnMagic || header_.version != kColumnVersion) {
+                SPDLOG_ERROR("Not a column file: {}.", path);
+                return false;
+            }
+            stats_ = (const BlockStats *) (data_.data() + sizeof(ColumnFileHeader));
+            return true;
+        }
+
+        const ColumnFileHeader &GetHeader() const {
+            return header_;
+        }
+
+        const BlockStats &GetStats(const size_t &block) const {
+            return stats_[block];
+        }
+
+        // 解码一个block, 值为64位扩展后的值
+        void ReadBlock(const size_t &block, std::vector<uint64_t> &values) const {
+            const auto &stats = stats_[block];
+            const auto type = (ColumnType) header_.type;
+            const char *p = data_.data() + stats.offset;
+            values.resize(stats.count);
+            for (size_t i = 0; i < stats.count; i++) {
+                if (header_.encoding == 0) {
+                    values[i] = LoadColumnValue(p, type);
+                    p += header_.width;
+                } else if (i == 0) {
+                    memcpy(&values[0], p, 8);
+                    p += 8;
+                } else {
+                    uint64_t zigzag = 0;
+                    for (int shift = 0;; shift += 7) {
+                        const uint8_t byte = *p++;
+                        zigzag |= uint64_t(byte & 0x7f) << shift;
+                        if (!(byte & 0x80)) {
+                            break;
+                        }
+                    }
+                    values[i] = values[i - 1] + ((zigzag >> 1) ^ -(zigzag & 1));
+                }
+            }
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_EXPORT_H
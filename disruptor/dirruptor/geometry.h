@@ -0,0 +1,72 @@
+#ifndef MULTI_SHM_QUEUE_GEOMETRY_H
+#define MULTI_SHM_QUEUE_GEOMETRY_H
+
+#include <bit>
+#include <cstddef>
+
+
+namespace disruptor {
+    // item在page文件中的布局, 所有参数都在编译期确定, 只有容量可以在运行时确定
+    //
+    // 原有布局(Capacity为0, 或item大小不是2的幂):
+    //   page0开头是书签, 之后是item; 每个page能放PageSize / ItemSize - 1个item
+    // 移位布局(Capacity大于0, item大小和PageSize都是2的幂):
+    //   书签占用page0开头的若干个item位置, 之后item连续排列, 定位只需要移位和掩码
+    template<size_t ItemSize, size_t MarkSize, size_t PageSize, size_t Capacity = 0>
+    class Geometry {
+    public:
+        static constexpr bool power_of_two = Capacity > 0 && std::has_single_bit(ItemSize) && std::has_single_bit(PageSize);
+
+        static constexpr size_t item_num_in_mark =
+                power_of_two ? (MarkSize + ItemSize - 1) / ItemSize : MarkSize / ItemSize + 1;//书签相当于多少个结构体
+        static constexpr size_t item_num_in_page =
+                power_of_two ? PageSize / ItemSize : PageSize / ItemSize - 1;//一页能装下多少item
+        static constexpr size_t item_num_in_first_page = item_num_in_page - item_num_in_mark;//第一页能装下多少item
+
+        static constexpr int item_shift = std::countr_zero(ItemSize);
+        static constexpr int page_shift = std::countr_zero(item_num_in_page);
+        static constexpr size_t page_mask = item_num_in_page - 1;
+
+        static_assert(PageSize / ItemSize > item_num_in_mark + 1, "page is too small for this item.");
+
+        // 需要多少page才能全部装下
+        static constexpr size_t PageNum(const size_t &item_num) {
+            if constexpr (power_of_two) {
+                return (item_num + item_num_in_mark + item_num_in_page - 1) / item_num_in_page;
+            } else {
+                return (item_num + item_num_in_mark) / item_num_in_page + 1;
+            }
+        }
+
+        static constexpr size_t page_num = Capacity > 0 ? PageNum(Capacity) : 0;//运行时容量为0
+
+        // item所在page
+        static constexpr size_t PageOf(const size_t &idx) {
+            if constexpr (power_of_two) {
+                return (idx + item_num_in_mark) >> page_shift;
+            } else {
+                return idx < item_num_in_first_page ? 0 : 1 + (idx - item_num_in_first_page) / item_num_in_page;
+            }
+        }
+
+        // item在page内的偏移
+        static constexpr size_t OffsetOf(const size_t &idx) {
+            if constexpr (power_of_two) {
+                return ((idx + item_num_in_mark) & page_mask) << item_shift;
+            } else {
+                return idx < item_num_in_first_page ? MarkSize + ItemSize * idx
+                                                    : ItemSize * ((idx - item_num_in_first_page) % item_num_in_page);
+            }
+        }
+
+        // page上第一个item的索引
+        static constexpr size_t FirstIndexOf(const size_t &page) {
+            if (page == 0) {
+                return 0;
+            }
+            return item_num_in_first_page + item_num_in_page * (page - 1);
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_GEOMETRY_H
@@ -0,0 +1,102 @@
+#ifndef MULTI_SHM_QUEUE_HEADER_H
+#define MULTI_SHM_QUEUE_HEADER_H
+
+#include "spdlog/spdlog.h"
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+
+namespace disruptor {
+    static constexpr uint64_t kMagic = 0x4b4f4f4245544f4e;//"NOTEBOOK"
+    static constexpr uint32_t kLayoutVersion = 1;          //布局版本, page文件格式变化时递增
+
+    // page0开头的描述信息, 写入方init时写入, 读取方据此校验并计算布局
+    struct Header {
+        uint64_t magic;      //固定为kMagic
+        uint32_t version;    //布局版本
+        uint32_t layout;     //0原有布局, 1移位布局, 2最新值, 3topic目录, 4arena
+        uint64_t item_size;  //结构体大小
+        uint64_t type_hash;  //结构体类型hash
+        uint64_t item_num;   //存入结构体数量
+        uint64_t page_size;  //page大小
+        uint64_t page_num;   //使用page数量
+        uint64_t mark_size;  //书签大小
+        int64_t create_time; //创建时间, 纳秒
+    };
+
+    // 结构体类型hash, 结构体可以通过static constexpr uint64_t schema_hash自行指定
+    // 否则使用编译器给出的类型名, 不同编译器之间可能不一致
+    template<typename T>
+    constexpr uint64_t TypeHash() {
+        if constexpr (requires { T::schema_hash; }) {
+            return T::schema_hash;
+        } else {
+            constexpr std::string_view name = __PRETTY_FUNCTION__;
+            uint64_t hash = 0xcbf29ce484222325;//FNV-1a
+            for (auto c: name) {
+                hash = (hash ^ (uint8_t) c) * 0x100000001b3;
+            }
+            hash = (hash ^ sizeof(T)) * 0x100000001b3;
+            hash = (hash ^ alignof(T)) * 0x100000001b3;
+            return hash;
+        }
+    }
+
+    template<typename T, typename Layout>
+    Header MakeHeader(const size_t &item_num, const size_t &page_size, const size_t &mark_size) {
+        Header header{};
+        header.magic = kMagic;
+        header.version = kLayoutVersion;
+        header.layout = Layout::power_of_two ? 1 : 0;
+        header.item_size = sizeof(T);
+        header.type_hash = TypeHash<T>();
+        header.item_num = item_num;
+        header.page_size = page_size;
+        header.page_num = Layout::PageNum(item_num);
+        header.mark_size = mark_size;
+        header.create_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count();
+        return header;
+    }
+
+    // 校验page0中的描述信息, expected.item_num为读取方需要的最少item数量
+    inline bool CheckHeader(const Header &actual, const Header &expected) {
+        if (actual.magic != kMagic) {
+            SPDLOG_ERROR("Bad magic: {:#x}, not a notebook or not initialized.", actual.magic);
+            return false;
+        }
+        if (actual.version != expected.version) {
+            SPDLOG_ERROR("Layout version mismatch, file:{}, expected:{}.", actual.version, expected.version);
+            return false;
+        }
+        if (actual.layout != expected.layout) {
+            SPDLOG_ERROR("Layout mismatch, file:{}, expected:{}.", actual.layout, expected.layout);
+            return false;
+        }
+        if (actual.item_size != expected.item_size) {
+            SPDLOG_ERROR("Item size mismatch, file:{}, expected:{}.", actual.item_size, expected.item_size);
+            return false;
+        }
+        if (actual.type_hash != expected.type_hash) {
+            SPDLOG_ERROR("Type hash mismatch, file:{:#x}, expected:{:#x}.", actual.type_hash, expected.type_hash);
+            return false;
+        }
+        if (actual.page_size != expected.page_size) {
+            SPDLOG_ERROR("Page size mismatch, file:{}, expected:{}.", actual.page_size, expected.page_size);
+            return false;
+        }
+        if (actual.mark_size != expected.mark_size) {
+            SPDLOG_ERROR("Mark size mismatch, file:{}, expected:{}.", actual.mark_size, expected.mark_size);
+            return false;
+        }
+        if (actual.item_num < expected.item_num) {
+            SPDLOG_ERROR("Item num too large, file:{}, expected:{}.", actual.item_num, expected.item_num);
+            return false;
+        }
+        return true;
+    }
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_HEADER_H
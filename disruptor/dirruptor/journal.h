@@ -0,0 +1,128 @@
+#ifndef MULTI_SHM_QUEUE_JOURNAL_H
+#define MULTI_SHM_QUEUE_JOURNAL_H
+
+#include "spmc.h"
+#include <vector>
+
+
+namespace disruptor {
+    // 加载Notebook的page文件, 不需要知道结构体类型, 布局全部从page0的描述信息读取
+    // 离线工具(校验, 导出, 回放)用来按位置读取原始的item, 回放时也用来写入新的Notebook
+    class Journal {
+    private:
+        Header header_{};
+        Bookmark *bookmark_ = nullptr;
+        std::vector<char *> pages_;
+        size_t item_num_in_mark_ = 0;
+        size_t item_num_in_page_ = 0;
+        size_t item_num_in_first_page_ = 0;
+
+    public:
+        Journal() = default;
+        Journal(const Journal &) = delete;
+        Journal &operator=(const Journal &) = delete;
+        ~Journal() {
+            for (auto page: pages_) {
+                munmap((void *) page, header_.page_size);
+            }
+        }
+
+        // 按header创建一个空的Notebook, 布局与header一致, 可以由相同类型的Notebook读取
+        static bool Create(const std::string &folder_path, const Header &header) {
+            for (size_t p = 0; p < header.page_num; p++) {
+                auto page = Page(folder_path + "_page_" + std::to_string(p) + ".store", true, header.page_size);
+                if (!page.GetShm()) {
+                    return false;
+                }
+                if (p == 0) {
+                    auto bookmark = (Bookmark *) page.GetShmDataAddress();
+                    bookmark->header = header;
+                    bookmark->header.create_time = NowNanos();
+                    bookmark->cursor = 0;
+                    ResetHeartbeat(bookmark->producer);
+                    bookmark->sample_num.store(0);
+                    for (auto &consumer: bookmark->consumers) {
+                        ResetHeartbeat(consumer);
+                    }
+                }
+                page.DetachShm();
+            }
+            return true;
+        }
+
+        bool Open(const std::string &folder_path, const bool &writable = false) {
+            auto header = (const Header *) Page::Map(folder_path + "_page_0.store", sizeof(Header), false);
+            if (header == nullptr) {
+                return false;
+            }
+            header_ = *header;
+            munmap((void *) header, sizeof(Header));
+            if (header_.magic != kMagic || header_.version != kLayoutVersion || header_.mark_size != sizeof(Bookmark) || header_.layout > 1) {
+                SPDLOG_ERROR("Not a notebook or layout mismatch: {}.", folder_path);
+                return false;
+            }
+
+            for (size_t p = 0; p < header_.page_num; p++) {
+                auto page = (char *) Page::Map(folder_path + "_page_" + std::to_string(p) + ".store", header_.page_size, writable);
+                if (page == nullptr) {
+                    return false;
+                }
+                pages_.push_back(page);
+            }
+            bookmark_ = (Bookmark *) pages_[0];
+            if (writable) {
+                bookmark_->producer.pid.store(getpid());
+            }
+
+            // 与Geometry相同的计算, 布局1为移位布局
+            const size_t item_size = header_.item_size;
+            item_num_in_mark_ = header_.layout == 1 ? (header_.mark_size + item_size - 1) / item_size : header_.mark_size / item_size + 1;
+            item_num_in_page_ = header_.layout == 1 ? header_.page_size / item_size : header_.page_size / item_size - 1;
+            item_num_in_first_page_ = item_num_in_page_ - item_num_in_mark_;
+            return true;
+        }
+
+        const Header &GetHeader() const {
+            return header_;
+        }
+
+        const Bookmark *GetBookmark() const {
+            return bookmark_;
+        }
+
+        // 已写入位置
+        size_t GetCursor() const {
+            return std::min<size_t>(bookmark_->cursor, header_.item_num);
+        }
+
+        size_t ItemSize() const {
+            return header_.item_size;
+        }
+
+        // 写入一个item, 需要以可写方式Open
+        bool Append(const void *item) {
+            const size_t cursor = bookmark_->cursor;
+            if (cursor >= header_.item_num) {
+                SPDLOG_ERROR("Journal is full, item_num:{}.", header_.item_num);
+                return false;
+            }
+            memcpy((char *) Item(cursor), item, header_.item_size);
+            bookmark_->cursor = cursor + 1;
+            return true;
+        }
+
+        const char *Item(const size_t &idx) const {
+            if (header_.layout == 1) {
+                const size_t n = idx + item_num_in_mark_;
+                return pages_[n / item_num_in_page_] + n % item_num_in_page_ * header_.item_size;
+            }
+            if (idx < item_num_in_first_page_) {
+                return pages_[0] + header_.mark_size + header_.item_size * idx;
+            }
+            const size_t n = idx - item_num_in_first_page_;
+            return pages_[1 + n / item_num_in_page_] + n % item_num_in_page_ * header_.item_size;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_JOURNAL_H
@@ -0,0 +1,113 @@
+#ifndef MULTI_SHM_QUEUE_LATEST_H
+#define MULTI_SHM_QUEUE_LATEST_H
+
+#include "spmc.h"
+#include <atomic>
+#include <type_traits>
+
+
+namespace disruptor {
+    // 只保存最新值的共享内存, 一写多读, 顺序锁(seqlock)
+    // 写入方不等待读取方, 读取方读到写入中途的数据时重试, 任何时候读取的都是最新的完整值
+    template<typename T>
+    class LatestValue {
+        static_assert(std::is_trivially_copyable_v<T>, "LatestValue requires a trivially copyable type.");
+
+        struct Slot {
+            Header header;                        //描述信息
+            alignas(64) std::atomic<size_t> sequence;//版本号, 奇数表示正在写入
+            alignas(64) T value;                  //最新值
+        };
+
+        static constexpr size_t slot_size = (sizeof(Slot) + 4 * Page::KB - 1) / (4 * Page::KB) * (4 * Page::KB);
+
+    private:
+        Slot *slot_ = nullptr;
+
+        static Header MakeSlotHeader() {
+            Header header{};
+            header.magic = kMagic;
+            header.version = kLayoutVersion;
+            header.layout = 2;
+            header.item_size = sizeof(T);
+            header.type_hash = TypeHash<T>();
+            header.item_num = 1;
+            header.page_size = slot_size;
+            header.page_num = 1;
+            header.mark_size = sizeof(Slot);
+            header.create_time = NowNanos();
+            return header;
+        }
+
+    public:
+        LatestValue() = default;
+        ~LatestValue() = default;
+
+        bool Init(const std::string &folder_path, const bool &writer, const bool &init) {
+            auto page = Page(folder_path + "_latest.store", writer, slot_size);
+            if (!page.GetShm()) {
+                return false;
+            }
+            slot_ = (Slot *) page.GetShmDataAddress();
+
+            const auto expected = MakeSlotHeader();
+            if (init) {
+                slot_->header = expected;
+                slot_->sequence.store(0);
+                memset(&slot_->value, 0, sizeof(T));
+            } else if (!CheckHeader(slot_->header, expected)) {
+                return false;
+            }
+            return true;
+        }
+
+        // 写入, 只能有一个写入方
+        void Store(const T &value) {
+            const size_t sequence = slot_->sequence.load(std::memory_order_relaxed);
+            slot_->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            CopyItem<sizeof(T)>(&slot_->value, &value);
+            slot_->sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        // 读取一次, 遇到写入中途的数据返回false
+        bool TryLoad(T &value) const {
+            const size_t begin = slot_->sequence.load(std::memory_order_acquire);
+            if (begin & 1) {
+                return false;
+            }
+            memcpy(&value, &slot_->value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot_->sequence.load(std::memory_order_relaxed) == begin;
+        }
+
+        // 读取最新值, 返回对应的版本号
+        size_t Load(T &value) const {
+            int nCounter = 100;
+            while (true) {
+                const size_t begin = slot_->sequence.load(std::memory_order_acquire);
+                if (!(begin & 1)) {
+                    memcpy(&value, &slot_->value, sizeof(T));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot_->sequence.load(std::memory_order_relaxed) == begin) {
+                        return begin / 2;
+                    }
+                }
+
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        // 已写入的次数, 读取方可以据此判断是否有更新
+        size_t Version() const {
+            return slot_->sequence.load(std::memory_order_acquire) / 2;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_LATEST_H
@@ -5,31 +5,84 @@
 #ifndef MULTI_SHM_QUEUE_DISRUPTOR_H
 #define MULTI_SHM_QUEUE_DISRUPTOR_H
 
+#include "copy.h"
+#include "geometry.h"
+#include "header.h"
 #include "spdlog/spdlog.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <csignal>
 #include <fcntl.h>
+#include <mutex>
 #include <string>
 #include <sys/ipc.h>
 #include <sys/mman.h>
 #include <sys/shm.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 
 namespace atomic_disruptor {
+    static constexpr size_t kMaxProducers = 64;//最多登记多少个生产者
+    static constexpr size_t kMaxGaps = 256;    //保留最近多少个跳过的位置
+    static constexpr size_t kNoClaim = -1;     //生产者没有占用位置
+    static constexpr size_t kClaiming = -2;    //生产者正在申请位置, 还不知道是哪个
+
+    // 生产者登记, 每个申请位置的线程一个, 用于发现退出时没有Commit的位置
+    struct Producer {
+        std::atomic<pid_t> pid;          //所属进程, 0表示空闲
+        std::atomic<uint32_t> claim_num; //已申请未提交的连续位置数量, 0视为1
+        std::atomic<size_t> claimed;     //已申请未提交的第一个位置
+        std::atomic<uint64_t> generation;//所属进程的启动时间, pid被复用之后不一致
+    };
+
     // 共享内存写入和读取的浮标
     struct Bookmark {
-        size_t item_num;           //存入结构体数量
-        size_t page_num;           // 使用page数量
-        std::atomic<size_t> cursor;//浮标，已写入位置
-        std::atomic<size_t> next;  //浮标，下次写入位置
-                                   //        size_t cursor;  //浮标，已写入位置
-                                   //        size_t next;    //浮标，下次写入位置
+        disruptor::Header header;           //描述信息，存入结构体数量、page数量等
+        std::atomic<size_t> cursor;         //浮标，已写入位置
+        std::atomic<size_t> next;           //浮标，下次写入位置
+        std::atomic<size_t> gap_num;        //跳过的位置总数
+        std::atomic<size_t> gaps[kMaxGaps]; //最近跳过的位置
+        std::atomic<pid_t> recovering;      //正在跳过位置的进程, 0表示空闲, 同一时间只有一个进程记录和跳过
+        std::atomic<uint64_t> recovering_generation;//正在跳过位置的进程的启动时间
+        Producer producers[kMaxProducers];  //生产者登记表
     };
 
+    // 进程启动时间, /proc/<pid>/stat的第22项, 单位为clock tick; 读取失败时返回0
+    inline uint64_t ProcessStart(const pid_t &pid) {
+        char buf[1024];
+        FILE *fp = fopen(("/proc/" + std::to_string(pid) + "/stat").c_str(), "r");
+        if (fp == nullptr) {
+            return 0;
+        }
+        const size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+        fclose(fp);
+        buf[len] = 0;
+
+        // 进程名可能包含空格, 从最后一个')'之后开始数, 之后第一项是第3项
+        const char *p = strrchr(buf, ')');
+        for (int field = 2; p != nullptr && field < 22; field++) {
+            p = strchr(p + 1, ' ');
+        }
+        return p == nullptr ? 0 : strtoull(p + 1, nullptr, 10);
+    }
+
+    // generation不为0时还要比较进程启动时间, 避免pid被新进程复用时误判为存活
+    inline bool ProcessAlive(const pid_t &pid, const uint64_t &generation = 0) {
+        if (kill(pid, 0) != 0 && errno != EPERM) {
+            return false;
+        }
+        const uint64_t start = generation == 0 ? 0 : ProcessStart(pid);
+        return start == 0 || start == generation;
+    }
+
     class Page {
     public:
         static constexpr int KB = 1024;
@@ -49,13 +102,15 @@ namespace atomic_disruptor {
     private:
         std::string file_path_;
         bool write_mode_;
+        size_t size_;
         void *data_ = nullptr;
 
     public:
-        Page(const std::string &file_path, const bool &write_mode) {
+        Page(const std::string &file_path, const bool &write_mode, const size_t &size = page_size) {
             file_path_ = file_path;
             write_mode_ = write_mode;
-            SPDLOG_DEBUG("Page, path:{}, mode:{}.", file_path_, write_mode_);
+            size_ = size;
+            SPDLOG_DEBUG("Page, path:{}, mode:{}, size:{}.", file_path_, write_mode_, size_);
         }
         ~Page() {
             SPDLOG_DEBUG("~Page, path:{}, mode:{}.", file_path_, write_mode_);
@@ -80,28 +135,28 @@ namespace atomic_disruptor {
 
             // 改变文件大小
             if (st.st_size == 0) {
-                if (ftruncate(fd, (int64_t) page_size) == 0) {
-                    SPDLOG_DEBUG("Ftruncate, file size:{}", page_size);
+                if (ftruncate(fd, (int64_t) size_) == 0) {
+                    SPDLOG_DEBUG("Ftruncate, file size:{}", size_);
                 } else {
-                    SPDLOG_ERROR("Failed to ftruncate {}, size:{}, error:{}", file_path_, page_size, strerror(errno));
+                    SPDLOG_ERROR("Failed to ftruncate {}, size:{}, error:{}", file_path_, size_, strerror(errno));
                     return false;
                 }
             } else {
                 SPDLOG_DEBUG("File exit,  path:{}, size:{}.", file_path_, st.st_size);
-                if (st.st_size != page_size) {
+                if ((size_t) st.st_size != size_) {
                     SPDLOG_ERROR("File exit,  path:{}, size:{}.", file_path_, st.st_size);
                     return false;
                 }
             }
 
             if (write_mode_) {
-                data_ = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
             } else {
-                data_ = mmap(nullptr, page_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
             }
 
             if (data_ == MAP_FAILED) {
-                SPDLOG_ERROR("Failed to mmap: {}, size: {}, errno: {}", file_path_, page_size, strerror(errno));
+                SPDLOG_ERROR("Failed to mmap: {}, size: {}, errno: {}", file_path_, size_, strerror(errno));
                 close(fd);
                 return false;
             } else {
@@ -111,13 +166,13 @@ namespace atomic_disruptor {
         }
 
         bool DetachShm() {
-            if (msync(data_, page_size, MS_SYNC) != 0) {
-                SPDLOG_ERROR("Failed to msync: {}, size: {}, errno: {}", file_path_, page_size, strerror(errno));
+            if (msync(data_, size_, MS_SYNC) != 0) {
+                SPDLOG_ERROR("Failed to msync: {}, size: {}, errno: {}", file_path_, size_, strerror(errno));
                 return false;
             }
 
-            if (munmap(data_, page_size) == -1) {
-                SPDLOG_ERROR("Failed to munmap: {}, size: {}, errno: {}", file_path_, page_size, strerror(errno));
+            if (munmap(data_, size_) == -1) {
+                SPDLOG_ERROR("Failed to munmap: {}, size: {}, errno: {}", file_path_, size_, strerror(errno));
                 return false;
             }
             data_ = nullptr;
@@ -131,6 +186,8 @@ namespace atomic_disruptor {
         void *GetShmDataAddress() { return data_; }
 
         auto GetFilePath() { return file_path_; }
+
+        size_t GetSize() const { return size_; }
     };
 
 
@@ -149,7 +206,7 @@ namespace atomic_disruptor {
             int nCounter = 100;
             while (true) {
                 const size_t current_cursor = bookmark_->cursor.load();
-                if (idx < current_cursor) {
+                if (idx < current_cursor + 1) {
                     return current_cursor;
                 } else {
                     //spins --> yield
@@ -164,136 +221,363 @@ namespace atomic_disruptor {
         }
     };
 
-    template<typename T>
+    // Capacity为0时item数量由Init参数确定, 否则在编译期确定, item定位全部为常量运算
+    template<typename T, size_t Capacity = 0, size_t PageSize = Page::page_size>
     class Notebook {
+    public:
+        using Layout = disruptor::Geometry<sizeof(T), sizeof(Bookmark), PageSize, Capacity>;
+
     private:
         size_t capacity_{};           //有多少item
-        std::vector<T *> content_;    //目录，指向所有item的内存地址
+        std::vector<char *> pages_;   //所有page的映射地址
         Bookmark *bookmark_ = nullptr;//书签
         WaitStrategy *wait_ = nullptr;
+        inline static std::atomic<uint64_t> instance_num_{0};
+        uint64_t instance_ = 0;           //对象编号, 每次Init或Attach重新分配, 线程缓存按编号查找登记
+        std::mutex mutex_;
+        std::vector<std::pair<std::thread::id, Producer *>> producers_;//本对象各个线程的生产者登记, 析构时释放
+
+        // 登记生产者, 空闲或者所属进程已经退出的登记可以复用; 持有mutex_时调用
+        Producer *RegisterProducer() {
+            const pid_t self = getpid();
+            const uint64_t generation = ProcessStart(self);
+            for (auto &producer: bookmark_->producers) {
+                pid_t pid = producer.pid.load();
+                if ((pid == 0 || !ProcessAlive(pid, producer.generation.load())) &&
+                    producer.pid.compare_exchange_strong(pid, self)) {
+                    producer.claimed.store(kNoClaim);
+                    producer.claim_num.store(1);
+                    producer.generation.store(generation);
+                    producers_.emplace_back(std::this_thread::get_id(), &producer);
+                    return &producer;
+                }
+            }
+            SPDLOG_ERROR("Too many producers, max:{}.", kMaxProducers);
+            return nullptr;
+        }
 
-    private:
-        bool SetCapacity(const size_t &capacity) {
-            try {
-                content_.reserve(capacity + 1024);
-            } catch (const std::length_error &e) {
-                SPDLOG_ERROR("SetCapacity Error: {}.", e.what());
+        // 调用线程的生产者登记, 多个线程共用一个对象写入时各自登记, 互不覆盖申请的位置
+        // 线程第一次申请位置时登记, 之后从线程缓存中读取; 登记表已满时返回nullptr, 不和其他线程共用登记
+        Producer *Self() {
+            struct Entry {
+                uint64_t instance;
+                Producer *producer;
+            };
+            thread_local std::array<Entry, 4> cache{};
+            thread_local size_t victim = 0;
+            for (auto &entry: cache) {
+                if (entry.instance == instance_) {
+                    return entry.producer;
+                }
+            }
+
+            // 缓存未命中时先查找本线程已有的登记, 没有再登记
+            std::lock_guard<std::mutex> lock(mutex_);
+            Producer *producer = nullptr;
+            for (auto &[tid, record]: producers_) {
+                if (tid == std::this_thread::get_id()) {
+                    producer = record;
+                }
+            }
+            if (producer == nullptr) {
+                producer = RegisterProducer();
+            }
+            if (producer == nullptr) {
+                return nullptr;
+            }
+            cache[victim++ % cache.size()] = {instance_, producer};
+            return producer;
+        }
+
+        // 提交之后清除调用线程的申请
+        void Release() {
+            Producer *producer = Self();
+            if (producer != nullptr) {
+                producer->claimed.store(kNoClaim);
+            }
+        }
+
+        void ReleaseProducers() {
+            for (auto &[tid, producer]: producers_) {
+                producer->claimed.store(kNoClaim);
+                producer->pid.store(0);
+            }
+            producers_.clear();
+        }
+
+        // 按顺序提交, 等待前一个位置提交之后才能提交; 等待过久时检查前面的位置是否被退出的进程占用
+        void Publish(const size_t &idx) {
+            int nCounter = 100;
+            size_t expected = idx - 1;
+            while (!bookmark_->cursor.compare_exchange_weak(expected, idx)) {
+                if (expected + 1 > idx) {
+                    SPDLOG_ERROR("Index {} has been skipped, cursor:{}.", idx, expected);
+                    break;
+                }
+                expected = idx - 1;
+
+                //spins --> yield --> recover
+                if (nCounter > 0) {
+                    nCounter--;
+                } else {
+                    std::this_thread::yield();
+                    if (--nCounter < -1000) {
+                        Recover();
+                        nCounter = 0;
+                    }
+                }
+            }
+        }
+
+        // 映射page, 从已映射的page数量开始
+        bool MapPages(const std::string &folder_path, const size_t &page_num, const bool &writer) {
+            pages_.reserve(page_num);
+            for (size_t p = pages_.size(); p < page_num; p++) {
+                std::string file_path = folder_path + "page" + std::to_string(p) + ".store";
+                auto page = Page(file_path, writer, PageSize);
+                if (!page.GetShm()) {
+                    return false;
+                }
+                pages_.push_back((char *) page.GetShmDataAddress());
+            }
+            return true;
+        }
+
+        // 持有recovering时调用; 先记录再跳过, 读取方看到cursor前进时一定能看到这个位置
+        bool SkipAbandoned() {
+            size_t current_cursor = bookmark_->cursor.load();
+            const size_t stuck = current_cursor + 1;
+            const size_t next = bookmark_->next.load();
+            if (next + 1 <= stuck) {
+                return false;//没有已申请未提交的位置
+            }
+
+            for (auto &producer: bookmark_->producers) {
+                pid_t pid = producer.pid.load();
+                if (pid == 0) {
+                    continue;
+                }
+                if (!ProcessAlive(pid, producer.generation.load())) {
+                    SPDLOG_WARN("Producer {} exited, claimed:{}.", pid, producer.claimed.load());
+                    producer.pid.compare_exchange_strong(pid, 0);
+                    continue;
+                }
+                const size_t claimed = producer.claimed.load();
+                const size_t claim_num = std::max<uint32_t>(producer.claim_num.load(), 1);
+                if (claimed == kClaiming || (claimed <= stuck && stuck - claimed < claim_num)) {
+                    return false;
+                }
+            }
+
+            // 检查期间生产者可能已经提交stuck并清除了申请, 这时不能记录
+            if (bookmark_->cursor.load() != current_cursor) {
+                return false;
+            }
+
+            // 没有存活的生产者占用stuck, 只有持有recovering的进程会移动cursor到stuck, 记录之后cursor不会被别人改变
+            const size_t gap_num = bookmark_->gap_num.load();
+            bookmark_->gaps[gap_num % kMaxGaps].store(stuck);
+            bookmark_->gap_num.store(gap_num + 1);
+            if (!bookmark_->cursor.compare_exchange_strong(current_cursor, stuck)) {
+                bookmark_->gaps[gap_num % kMaxGaps].store(kNoClaim);
+                SPDLOG_ERROR("Cursor moved while skipping index {}.", stuck);
                 return false;
             }
-            capacity_ = capacity;
+            SPDLOG_WARN("Skip abandoned index {}.", stuck);
             return true;
         }
 
+        T *Address(const size_t &idx) const {
+            if constexpr (Layout::page_num == 1) {
+                return (T *) (pages_[0] + Layout::OffsetOf(idx));
+            } else {
+                return (T *) (pages_[Layout::PageOf(idx)] + Layout::OffsetOf(idx));
+            }
+        }
+
     public:
+        static constexpr size_t kNoIndex = kNoClaim;//ClaimIndex失败
+
         Notebook() = default;
-        ~Notebook() = default;
+        Notebook(const Notebook &) = delete;
+        Notebook &operator=(const Notebook &) = delete;
+        ~Notebook() {
+            ReleaseProducers();
+        }
 
         bool Init(const std::string &folder_path, const size_t &item_num, const bool &writer, const bool &init) {
-            if (!SetCapacity(item_num)) {
+            if (Capacity > 0 && item_num != Capacity) {
+                SPDLOG_ERROR("Item num {} does not match capacity {}.", item_num, Capacity);
                 return false;
             }
+            capacity_ = item_num;
 
-            const size_t item_size = sizeof(T);                              //结构体大小
-            const size_t item_num_in_mark = sizeof(Bookmark) / item_size + 1;//书签相当于多少个结构体
-            const size_t total_item_num = item_num + item_num_in_mark;       //书签和结构体加总相当于多少个item结构体的空间占用
-            const size_t item_num_in_page = Page::page_size / item_size - 1; //一页能装下多少item
-            const size_t page_num = total_item_num / item_num_in_page + 1;   //需要多少page才能全部装下
-            size_t idx = 0;                                                  //目录索引，对应读取写入游标
+            const size_t page_num = Layout::PageNum(item_num);//需要多少page才能全部装下
             SPDLOG_DEBUG("params.");
-            SPDLOG_DEBUG("item_size:{}", item_size);
+            SPDLOG_DEBUG("item_size:{}", sizeof(T));
             SPDLOG_DEBUG("item_num:{}", item_num);
             SPDLOG_DEBUG("mark_size:{}", sizeof(Bookmark));
-            SPDLOG_DEBUG("item_num_in_mark:{}", item_num_in_mark);
-            SPDLOG_DEBUG("item_num_in_page:{}", item_num_in_page);
+            SPDLOG_DEBUG("item_num_in_mark:{}", Layout::item_num_in_mark);
+            SPDLOG_DEBUG("item_num_in_page:{}", Layout::item_num_in_page);
             SPDLOG_DEBUG("page_num:{}", page_num);
-            SPDLOG_DEBUG("page_size:{}", Page::page_size);
-            SPDLOG_DEBUG("total_item_num:{}", total_item_num);
-            SPDLOG_DEBUG("item_num_in_all_page:{}", item_num_in_page * page_num);
-
-            // 创建第一个Page，书签Bookmark也在这个页面上面
-            {
-                std::string file_path = folder_path + "page0.store";
-                auto page = Page(file_path, writer);
-                if (!page.GetShm()) {
-                    return false;
-                }
-
-                // 书签
-                bookmark_ = (Bookmark *) page.GetShmDataAddress();
-                wait_ = new WaitStrategy(bookmark_);
-                if (init) {
-                    bookmark_->item_num = item_num;
-                    bookmark_->page_num = page_num;
-                    bookmark_->cursor.store(-1);
-                    bookmark_->next.store(-1);
-                }
+            SPDLOG_DEBUG("page_size:{}", PageSize);
+            SPDLOG_DEBUG("power_of_two:{}", Layout::power_of_two);
 
-                // 只使用一个页面
-                if (page_num == 1) {
-                    for (auto i = 0; i < item_num; i++) {
-                        content_[i] = (T *) ((char *) page.GetShmDataAddress() + sizeof(Bookmark) + sizeof(T) * i);
-                    }
-                    return true;
-                }
+            ReleaseProducers();
+            instance_ = ++instance_num_;
+            pages_.clear();
+            if (!MapPages(folder_path, page_num, writer)) {
+                return false;
+            }
 
-                //使用多个页面
-                for (auto i = 0; i < item_num_in_page - item_num_in_mark; i++) {
-                    content_[idx++] = (T *) ((char *) page.GetShmDataAddress() + sizeof(Bookmark) + sizeof(T) * i);
+            // 书签在第一个Page开头
+            bookmark_ = (Bookmark *) pages_[0];
+            wait_ = new WaitStrategy(bookmark_);
+            const auto expected = disruptor::MakeHeader<T, Layout>(item_num, PageSize, sizeof(Bookmark));
+            if (init) {
+                bookmark_->header = expected;
+                bookmark_->cursor.store(-1);
+                bookmark_->next.store(-1);
+                bookmark_->gap_num.store(0);
+                bookmark_->recovering.store(0);
+                bookmark_->recovering_generation.store(0);
+                for (auto &producer: bookmark_->producers) {
+                    producer.pid.store(0);
+                    producer.claim_num.store(1);
+                    producer.claimed.store(kNoClaim);
+                    producer.generation.store(0);
                 }
+            } else if (!disruptor::CheckHeader(bookmark_->header, expected)) {
+                return false;
             }
+            return !writer || Self() != nullptr;
+        }
 
-            //Pages
-            for (auto p = 1; p < page_num; p++) {
-                std::string file_path = folder_path + "page" + std::to_string(p) + ".store";
-                auto page = Page(file_path, writer);
-                if (!page.GetShm()) {
-                    return false;
-                }
+        // 只根据路径加载已经init过的Notebook, 容量和page数量从page0的描述信息读取
+        bool Attach(const std::string &folder_path, const bool &writer = false) {
+            ReleaseProducers();
+            instance_ = ++instance_num_;
+            pages_.clear();
+            if (!MapPages(folder_path, 1, writer)) {
+                return false;
+            }
 
-                auto left_item_num =
-                        total_item_num - (item_num_in_page - item_num_in_mark) - item_num_in_page * (p - 1);
-                if (left_item_num < item_num_in_page) {
-                    for (auto i = 0; i < left_item_num; i++) {
-                        content_[idx++] = (T *) ((char *) page.GetShmDataAddress() + sizeof(T) * i);
-                    }
-                } else {
-                    for (auto i = 0; i < item_num_in_page; i++) {
-                        content_[idx++] = (T *) ((char *) page.GetShmDataAddress() + sizeof(T) * i);
-                    }
-                }
+            bookmark_ = (Bookmark *) pages_[0];
+            const disruptor::Header &header = bookmark_->header;
+            if (!disruptor::CheckHeader(header, disruptor::MakeHeader<T, Layout>(Capacity, PageSize, sizeof(Bookmark)))) {
+                return false;
             }
+            capacity_ = Capacity > 0 ? Capacity : header.item_num;
+            if (!MapPages(folder_path, Capacity > 0 ? Layout::page_num : header.page_num, writer)) {
+                return false;
+            }
+            wait_ = new WaitStrategy(bookmark_);
+            if (writer && Self() == nullptr) {
+                return false;
+            }
+            SPDLOG_DEBUG("Attach, path:{}, item_num:{}, page_num:{}, create_time:{}.",
+                         folder_path, header.item_num, header.page_num, header.create_time);
             return true;
         }
 
-        size_t ClaimIndex() {
-            return bookmark_->next++ + 1;
+        const disruptor::Header &GetHeader() const {
+            return bookmark_->header;
+        }
+
+        // 申请位置前先标记为申请中, 保证进程在申请和登记之间退出时也能被发现
+        // n大于1时申请连续的n个位置, 返回第一个, 用CommitBatch提交
+        // n不在1和容量之间, 或者生产者登记表已满时返回kNoIndex, 不改变next
+        // 每个线程同一时间只能有一个未提交的申请, 并且要在申请的线程中提交
+        size_t ClaimIndex(const uint32_t &n = 1) {
+            if (n == 0 || n > capacity_) {
+                SPDLOG_ERROR("Invalid claim num {}, item num:{}.", n, capacity_);
+                return kNoIndex;
+            }
+            Producer *producer = Self();
+            if (producer == nullptr) {
+                SPDLOG_ERROR("Failed to claim, no producer record for this thread.");
+                return kNoIndex;
+            }
+            producer->claimed.store(kClaiming);
+            producer->claim_num.store(n);
+            const size_t idx = bookmark_->next.fetch_add(n) + 1;
+            producer->claimed.store(idx);
+            return idx;
         };
 
         void SetData(const size_t &idx, T *data) {
-            constexpr size_t item_size = sizeof(T);
-            memcpy(content_[idx], data, item_size);
+            disruptor::CopyItem<sizeof(T)>(Address(idx), data);
         }
 
         T *OpenData(const size_t &idx) {
-            return content_[idx];
+            return Address(idx);
         }
 
         void Commit(const size_t &idx) {
-            bookmark_->cursor.store(idx);
+            Publish(idx);
+            Release();
         };
 
+        // 提交ClaimIndex(n)申请的连续n个位置
+        void CommitBatch(const size_t &first, const size_t &n) {
+            for (auto idx = first; idx < first + n; idx++) {
+                Publish(idx);
+            }
+            Release();
+        }
+
+        // 检查cursor之后的第一个位置, 如果没有存活的生产者占用, 说明占用它的进程已经退出, 跳过该位置
+        // 写入方或者看门狗定期调用, 返回是否跳过了位置
+        bool Recover() {
+            // 同一时间只有一个进程检查和跳过, 持有者退出时可以抢占
+            const pid_t self = getpid();
+            pid_t holder = bookmark_->recovering.load();
+            if (holder != 0 && ProcessAlive(holder, bookmark_->recovering_generation.load())) {
+                return false;
+            }
+            if (!bookmark_->recovering.compare_exchange_strong(holder, self)) {
+                return false;
+            }
+            bookmark_->recovering_generation.store(ProcessStart(self));
+            const bool skipped = SkipAbandoned();
+            bookmark_->recovering.store(0);
+            return skipped;
+        }
+
+        // 已提交的数量, 即下一个待提交的位置, 与disruptor::Notebook::GetCursor一致
+        size_t GetCursor() const {
+            return bookmark_->cursor.load() + 1;
+        }
+
         //consumer
         size_t WaitFor(const size_t &idx) {
             const size_t current_cursor = bookmark_->cursor.load();
-            if (idx > current_cursor) {
-                return wait_->Wait(idx);
-            } else {
+            if (idx < current_cursor + 1) {
                 return current_cursor;
+            } else {
+                return wait_->Wait(idx);
+            }
+        }
+
+        // 该位置是否因为生产者退出而被跳过, 被跳过的位置没有有效数据
+        // 只保留最近kMaxGaps个跳过的位置, 读取方落后超过kMaxGaps个跳过的位置时无法判断, 需要及时检查
+        // 撤销的记录为kNoClaim; 检查期间gap_num变化时记录可能被覆盖, 重新检查
+        bool IsSkipped(const size_t &idx) const {
+            while (true) {
+                const size_t gap_num = bookmark_->gap_num.load();
+                bool skipped = false;
+                for (size_t i = gap_num > kMaxGaps ? gap_num - kMaxGaps : 0; i < gap_num && !skipped; i++) {
+                    const size_t gap = bookmark_->gaps[i % kMaxGaps].load();
+                    skipped = gap != kNoClaim && gap == idx;
+                }
+                if (bookmark_->gap_num.load() == gap_num) {
+                    return skipped;
+                }
             }
         }
 
         T *GetData(const size_t &idx) {
-            return content_[idx];
+            return Address(idx);
         }
     };
 }// namespace atomic_disruptor
@@ -0,0 +1,134 @@
+#ifndef MULTI_SHM_QUEUE_NUMA_H
+#define MULTI_SHM_QUEUE_NUMA_H
+
+#include "spdlog/spdlog.h"
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace disruptor {
+    // 内存策略, 与内核的MPOL_*一致, 直接使用系统调用, 不依赖libnuma
+    static constexpr int kMemDefault = 0;   //按首次访问的cpu分配
+    static constexpr int kMemPreferred = 1; //优先第一个节点
+    static constexpr int kMemBind = 2;      //只在指定节点上分配
+    static constexpr int kMemInterleave = 3;//在指定节点上交替分配
+    static constexpr unsigned kMemMove = 2; //MPOL_MF_MOVE, 已经分配的页也迁移
+    static constexpr size_t kMaxNodes = 1024;
+
+    inline bool NodeMask(const std::vector<int> &nodes, std::vector<unsigned long> &mask) {
+        constexpr size_t bits = sizeof(unsigned long) * 8;
+        mask.assign(kMaxNodes / bits, 0);
+        for (auto node: nodes) {
+            if (node < 0 || (size_t) node >= kMaxNodes) {
+                SPDLOG_ERROR("Bad numa node: {}.", node);
+                return false;
+            }
+            mask[node / bits] |= 1ul << (node % bits);
+        }
+        return true;
+    }
+
+    // 设置[address, address + length)的内存策略, 地址需要按系统页对齐
+    // 匿名内存和tmpfs(/dev/shm)上的文件按策略分配; 普通文件的page cache仍然按首次访问分配, 以Residency的结果为准
+    inline bool BindMemory(void *address, const size_t &length, const int &policy, const std::vector<int> &nodes) {
+#if defined(SYS_mbind)
+        std::vector<unsigned long> mask;
+        if (!NodeMask(nodes, mask)) {
+            return false;
+        }
+        if (syscall(SYS_mbind, address, length, policy, policy == kMemDefault ? nullptr : mask.data(), kMaxNodes + 1, kMemMove) != 0) {
+            SPDLOG_ERROR("Failed to mbind: {}, size: {}, policy: {}, errno: {}", address, length, policy, strerror(errno));
+            return false;
+        }
+        return true;
+#else
+        SPDLOG_ERROR("mbind is not supported.");
+        return false;
+#endif
+    }
+
+    // 设置调用线程之后分配内存的策略
+    inline bool SetMemPolicy(const int &policy, const std::vector<int> &nodes) {
+#if defined(SYS_set_mempolicy)
+        std::vector<unsigned long> mask;
+        if (!NodeMask(nodes, mask)) {
+            return false;
+        }
+        if (syscall(SYS_set_mempolicy, policy, policy == kMemDefault ? nullptr : mask.data(), kMaxNodes + 1) != 0) {
+            SPDLOG_ERROR("Failed to set_mempolicy, policy: {}, errno: {}", policy, strerror(errno));
+            return false;
+        }
+        return true;
+#else
+        SPDLOG_ERROR("set_mempolicy is not supported.");
+        return false;
+#endif
+    }
+
+    // 查询[address, address + length)中每个系统页所在的节点, nodes[i]为节点i上的页数, absent为尚未驻留的页数
+    // 每次调用先清空nodes和absent, 不累加上一次的结果
+    inline bool Residency(const void *address, const size_t &length, std::vector<size_t> &nodes, size_t &absent) {
+        nodes.clear();
+        absent = 0;
+#if defined(SYS_move_pages)
+        static const size_t os_page_size = sysconf(_SC_PAGESIZE);
+        constexpr size_t batch = 4096;
+        std::vector<void *> pages(batch);
+        std::vector<int> status(batch);
+        const auto begin = (uintptr_t) address & ~(os_page_size - 1);
+        const auto end = (uintptr_t) address + length;
+        for (auto page = begin; page < end;) {
+            size_t n = 0;
+            for (; n < batch && page < end; n++, page += os_page_size) {
+                pages[n] = (void *) page;
+            }
+            if (syscall(SYS_move_pages, 0, n, pages.data(), nullptr, status.data(), 0) != 0) {
+                SPDLOG_ERROR("Failed to move_pages, errno: {}", strerror(errno));
+                return false;
+            }
+            for (size_t i = 0; i < n; i++) {
+                if (status[i] < 0) {
+                    absent++;
+                } else {
+                    if ((size_t) status[i] >= nodes.size()) {
+                        nodes.resize(status[i] + 1, 0);
+                    }
+                    nodes[status[i]]++;
+                }
+            }
+        }
+        return true;
+#else
+        SPDLOG_ERROR("move_pages is not supported.");
+        return false;
+#endif
+    }
+
+    inline std::string FormatNodes(const std::vector<int> &nodes) {
+        std::string out;
+        for (auto node: nodes) {
+            out += (out.empty() ? "" : ",") + std::to_string(node);
+        }
+        return out;
+    }
+
+    // 驻留报告, 每个节点上的页数和比例
+    inline std::string FormatResidency(const std::vector<size_t> &nodes, const size_t &absent) {
+        size_t total = absent;
+        for (auto n: nodes) {
+            total += n;
+        }
+        std::string out;
+        for (size_t node = 0; node < nodes.size(); node++) {
+            out += fmt::format("node{}: {} ({:.1f}%), ", node, nodes[node], total == 0 ? 0.0 : 100.0 * nodes[node] / total);
+        }
+        out += fmt::format("absent: {} ({:.1f}%)", absent, total == 0 ? 0.0 : 100.0 * absent / total);
+        return out;
+    }
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_NUMA_H
@@ -0,0 +1,228 @@
+#ifndef MULTI_SHM_QUEUE_PLACEMENT_H
+#define MULTI_SHM_QUEUE_PLACEMENT_H
+
+#include "topology.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sched.h>
+#include <string>
+#include <vector>
+
+
+namespace disruptor {
+    // 线程角色
+    enum class Role {
+        kProducer,  //生产者, 独占一个cpu
+        kConsumer,  //消费者, 多个读取进程按slot分散到不同的cpu
+        kBackground,//日志, 监控等后台线程, 不占用生产者和消费者的cpu
+    };
+
+    inline const char *RoleName(const Role &role) {
+        static constexpr const char *names[] = {"producer", "consumer", "background"};
+        return names[(int) role];
+    }
+
+    // 把线程固定到cpu集合上, 只影响调用线程
+    inline bool PinThread(const std::vector<int> &cpus) {
+#if defined __linux__
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (auto cpu: cpus) {
+            CPU_SET(cpu, &mask);
+        }
+        return 0 == sched_setaffinity(0, sizeof(mask), &mask);
+#else
+        return false;
+#endif
+    }
+
+    // cpu放置策略, 替代原来在Notebook::Init中固定到cpu 1的做法
+    // 每个角色一个cpu集合, 可以直接指定, 也可以按NUMA节点选择; 没有指定时生产者和消费者使用隔离的cpu,
+    // 后台线程使用其余的cpu. Validate检查集合是否可用并给出警告, Apply把调用线程固定到所属角色的cpu上
+    class Placement {
+    private:
+        Topology topology_;
+        std::vector<int> allowed_; //进程允许使用的cpu
+        std::vector<int> isolated_;//内核参数isolcpus隔离的cpu
+        std::array<std::vector<int>, 3> cpus_;
+
+        bool Allowed(const int &cpu) const {
+            return std::find(allowed_.begin(), allowed_.end(), cpu) != allowed_.end();
+        }
+
+        bool Isolated(const int &cpu) const {
+            return std::find(isolated_.begin(), isolated_.end(), cpu) != isolated_.end();
+        }
+
+    public:
+        bool Load() {
+            if (!topology_.Load()) {
+                return false;
+            }
+            isolated_ = ParseCpuList(ReadSysFile("/sys/devices/system/cpu/isolated"));
+            allowed_.clear();
+#if defined __linux__
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+                for (auto &info: topology_.Cpus()) {
+                    if (CPU_ISSET(info.cpu, &mask)) {
+                        allowed_.push_back(info.cpu);
+                    }
+                }
+            }
+#endif
+            if (allowed_.empty()) {
+                for (auto &info: topology_.Cpus()) {
+                    allowed_.push_back(info.cpu);
+                }
+            }
+
+            // 默认三个角色的cpu互不重叠: 生产者独占候选cpu中的最后一个, 消费者使用其余的候选cpu,
+            // 后台线程使用不在候选中的cpu; 有隔离的cpu时候选为隔离的cpu, 否则为所有允许使用的cpu
+            std::vector<int> isolated;
+            for (auto cpu: isolated_) {
+                if (Allowed(cpu)) {
+                    isolated.push_back(cpu);
+                }
+            }
+            const std::vector<int> &candidates = isolated.empty() ? allowed_ : isolated;
+            const int producer = candidates.back();
+            std::vector<int> consumer(candidates.begin(), candidates.end() - 1);
+            std::vector<int> background;
+            for (auto cpu: allowed_) {
+                if (cpu != producer && (isolated.empty() || !Isolated(cpu))) {
+                    background.push_back(cpu);
+                }
+            }
+            cpus_[(int) Role::kProducer] = {producer};
+            cpus_[(int) Role::kConsumer] = consumer.empty() ? candidates : consumer;
+            cpus_[(int) Role::kBackground] = background.empty() ? allowed_ : background;
+            return true;
+        }
+
+        void SetCpus(const Role &role, const std::vector<int> &cpus) {
+            cpus_[(int) role] = cpus;
+        }
+
+        // 使用NUMA节点上允许使用的cpu, 优先使用隔离的cpu
+        bool SetNode(const Role &role, const int &node) {
+            std::vector<int> isolated, other;
+            for (auto &info: topology_.Cpus()) {
+                if (info.node == node && Allowed(info.cpu)) {
+                    (Isolated(info.cpu) ? isolated : other).push_back(info.cpu);
+                }
+            }
+            if (isolated.empty() && other.empty()) {
+                SPDLOG_ERROR("No usable cpu on node {}.", node);
+                return false;
+            }
+            cpus_[(int) role] = isolated.empty() || role == Role::kBackground ? other : isolated;
+            return true;
+        }
+
+        const std::vector<int> &GetCpus(const Role &role) const {
+            return cpus_[(int) role];
+        }
+
+        const std::vector<int> &IsolatedCpus() const {
+            return isolated_;
+        }
+
+        Topology &GetTopology() {
+            return topology_;
+        }
+
+        // 检查放置是否可用: cpu必须在线并且允许使用; 对共享cpu和超线程给出警告
+        bool Validate() {
+            bool ok = true;
+            for (int r = 0; r < 3; r++) {
+                const auto role = (Role) r;
+                if (cpus_[r].empty()) {
+                    SPDLOG_ERROR("No cpu for {}.", RoleName(role));
+                    ok = false;
+                }
+                for (auto cpu: cpus_[r]) {
+                    if (topology_.Find(cpu) == nullptr || !Allowed(cpu)) {
+                        SPDLOG_ERROR("Cpu {} for {} is offline or not allowed.", cpu, RoleName(role));
+                        ok = false;
+                    } else if (role != Role::kBackground && !isolated_.empty() && !Isolated(cpu)) {
+                        SPDLOG_WARN("Cpu {} for {} is not isolated.", cpu, RoleName(role));
+                    }
+                }
+            }
+
+            // 每类问题汇总为一条警告, 涉及的cpu按列表输出
+            auto &producer = cpus_[(int) Role::kProducer];
+            std::vector<int> background_shared, consumer_shared, smt, remote;
+            for (auto cpu: cpus_[(int) Role::kBackground]) {
+                if (std::find(producer.begin(), producer.end(), cpu) != producer.end()) {
+                    background_shared.push_back(cpu);
+                }
+            }
+            for (auto b: cpus_[(int) Role::kConsumer]) {
+                for (auto a: producer) {
+                    if (a == b) {
+                        consumer_shared.push_back(b);
+                        break;
+                    }
+                    const auto relation = topology_.Relation(a, b);
+                    if (relation == "smt") {
+                        smt.push_back(b);
+                        break;
+                    } else if (relation == "node") {
+                        remote.push_back(b);
+                        break;
+                    }
+                }
+            }
+            if (!background_shared.empty()) {
+                SPDLOG_WARN("Cpu {} shared by producer and background threads.", FormatCpuList(background_shared));
+            }
+            if (!consumer_shared.empty()) {
+                SPDLOG_WARN("Cpu {} shared by producer and consumer.", FormatCpuList(consumer_shared));
+            }
+            if (!smt.empty()) {
+                SPDLOG_WARN("Consumer cpu {} are smt siblings of producer cpu {}.", FormatCpuList(smt), FormatCpuList(producer));
+            }
+            if (!remote.empty()) {
+                SPDLOG_WARN("Consumer cpu {} are on a different numa node from producer cpu {}.", FormatCpuList(remote), FormatCpuList(producer));
+            }
+            return ok;
+        }
+
+        // 把调用线程固定到角色的cpu上; slot不小于0时只使用第slot % n个cpu, 例如生产者用0, 各个读取进程用各自的编号
+        bool Apply(const Role &role, const int &slot = -1) {
+            const auto &cpus = cpus_[(int) role];
+            if (cpus.empty()) {
+                SPDLOG_ERROR("No cpu for {}.", RoleName(role));
+                return false;
+            }
+            const std::vector<int> target = slot < 0 ? cpus : std::vector<int>{cpus[slot % cpus.size()]};
+            if (!PinThread(target)) {
+                SPDLOG_ERROR("Failed to pin {} to cpu {}, errno: {}", RoleName(role), FormatCpuList(target), strerror(errno));
+                return false;
+            }
+            SPDLOG_INFO("Pin {} to cpu {}.", RoleName(role), FormatCpuList(target));
+            return true;
+        }
+
+        // 放置报告
+        std::string Report() {
+            std::string out = fmt::format("isolated: [{}], allowed: [{}]\n", FormatCpuList(isolated_), FormatCpuList(allowed_));
+            for (int r = 0; r < 3; r++) {
+                out += fmt::format("{:<12}", RoleName((Role) r));
+                for (auto cpu: cpus_[r]) {
+                    auto info = topology_.Find(cpu);
+                    out += info == nullptr ? fmt::format(" {}(offline)", cpu)
+                                           : fmt::format(" {}(node{}{})", cpu, info->node, Isolated(cpu) ? ",isolated" : "");
+                }
+                out += "\n";
+            }
+            return out;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_PLACEMENT_H
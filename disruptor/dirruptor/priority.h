@@ -0,0 +1,126 @@
+#ifndef MULTI_SHM_QUEUE_PRIORITY_H
+#define MULTI_SHM_QUEUE_PRIORITY_H
+
+#include "spmc.h"
+#include <array>
+
+
+namespace disruptor {
+    // 严格优先级队列, 每个优先级一个Notebook, lane 0优先级最高
+    // 消费者每读一条都先检查更高优先级的lane, 紧急消息不需要排在大量低优先级消息之后
+    // 低优先级lane在有数据时等待了starvation_limit条更高优先级的消息之后, 强制读取它一条, 避免饿死
+    template<typename T, size_t Lanes, size_t Capacity = 0, size_t PageSize = Page::page_size>
+    class PriorityNotebook {
+        static_assert(Lanes > 0, "PriorityNotebook requires at least one lane.");
+
+    private:
+        std::array<Notebook<T, Capacity, PageSize>, Lanes> lanes_;
+        std::array<size_t, Lanes> position_{}; //每个lane下一个待读取的位置
+        std::array<size_t, Lanes> cursor_{};   //每个lane上次读取的浮标
+        std::array<size_t, Lanes> waited_{};   //有数据时已经等待的条数
+        std::array<size_t, Lanes> forced_{};   //因为等待过久被强制读取的条数
+        size_t starvation_limit_ = 1024;
+
+        // 该lane是否有未读取的数据, 缓存的浮标读完之后才重新读取浮标
+        bool Pending(const size_t &lane) {
+            if (position_[lane] < cursor_[lane]) {
+                return true;
+            }
+            cursor_[lane] = lanes_[lane].GetCursor();
+            return position_[lane] < cursor_[lane];
+        }
+
+    public:
+        PriorityNotebook() = default;
+        ~PriorityNotebook() = default;
+
+        // 每个lane的文件为folder_path_lane<i>, 各自容纳item_num条
+        bool Init(const std::string &folder_path, const size_t &item_num, const bool &writer, const bool &init) {
+            for (size_t lane = 0; lane < Lanes; lane++) {
+                if (!lanes_[lane].Init(folder_path + "_lane" + std::to_string(lane), item_num, writer, init)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // 更高优先级的lane连续读取多少条之后强制读取一条等待中的低优先级消息, 0表示不限制
+        void SetStarvationLimit(const size_t &limit) {
+            starvation_limit_ = limit;
+        }
+
+        //producer
+        void SetData(const size_t &lane, const T &data) {
+            lanes_[lane].SetData(data);
+        }
+
+        //consumer
+        // 按优先级读取最多max_num条, 对每一条调用handler(lane, idx, data), 返回读取的数量
+        template<typename Func>
+        size_t Poll(Func &&handler, const size_t &max_num = -1) {
+            size_t n = 0;
+            while (n < max_num) {
+                size_t lane = Lanes;
+                for (size_t l = 0; l < Lanes; l++) {
+                    if (Pending(l)) {
+                        lane = l;
+                        break;
+                    }
+                }
+                if (lane == Lanes) {
+                    break;
+                }
+
+                // 等待过久的低优先级lane优先
+                if (starvation_limit_ > 0) {
+                    for (size_t l = lane + 1; l < Lanes; l++) {
+                        if (Pending(l) && ++waited_[l] > starvation_limit_) {
+                            forced_[l]++;
+                            lane = l;
+                            break;
+                        }
+                    }
+                }
+                waited_[lane] = 0;
+
+                const size_t idx = position_[lane]++;
+                handler(lane, idx, lanes_[lane].GetData(idx));
+                n++;
+            }
+            return n;
+        }
+
+        // 等待直到有数据, 返回读取的数量
+        template<typename Func>
+        size_t Select(Func &&handler, const size_t &max_num = -1) {
+            int nCounter = 100;
+            while (true) {
+                if (auto n = Poll(handler, max_num); n > 0) {
+                    return n;
+                }
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        // 该lane下一个待读取的位置
+        size_t Position(const size_t &lane) const {
+            return position_[lane];
+        }
+
+        // 该lane因为等待过久被强制读取的条数
+        size_t Forced(const size_t &lane) const {
+            return forced_[lane];
+        }
+
+        Notebook<T, Capacity, PageSize> &GetLane(const size_t &lane) {
+            return lanes_[lane];
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_PRIORITY_H
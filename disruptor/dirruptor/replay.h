@@ -0,0 +1,135 @@
+#ifndef MULTI_SHM_QUEUE_REPLAY_H
+#define MULTI_SHM_QUEUE_REPLAY_H
+
+#include "journal.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+
+namespace disruptor {
+    // TSC时钟, 启动时用steady_clock校准频率; 不支持TSC的平台直接使用steady_clock
+    class TscClock {
+    private:
+        double ns_per_tick_ = 1.0;
+
+    public:
+        static uint64_t Ticks() {
+#if defined(__x86_64__)
+            return __rdtsc();
+#else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+
+        // 校准, duration为校准时长
+        void Calibrate(const std::chrono::milliseconds &duration = std::chrono::milliseconds(50)) {
+#if defined(__x86_64__)
+            const auto begin = std::chrono::steady_clock::now();
+            const uint64_t begin_ticks = Ticks();
+            std::this_thread::sleep_for(duration);
+            const auto end = std::chrono::steady_clock::now();
+            const uint64_t end_ticks = Ticks();
+            ns_per_tick_ = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / (double) (end_ticks - begin_ticks);
+            SPDLOG_INFO("Tsc calibrate, {:.3f} GHz.", 1.0 / ns_per_tick_);
+#endif
+        }
+
+        double ToNanos(const int64_t &ticks) const {
+            return ticks * ns_per_tick_;
+        }
+
+        uint64_t FromNanos(const double &nanos) const {
+            return (uint64_t) (nanos / ns_per_tick_);
+        }
+    };
+
+    // 回放偏差统计, 纳秒, 正数表示晚于目标时间
+    struct ReplayReport {
+        size_t count;
+        double mean;
+        int64_t p50;
+        int64_t p99;
+        int64_t p999;
+        int64_t max;
+        double elapsed;//实际用时, 秒
+    };
+
+    // 按记录的时间间隔回放, 可以加速或者减速; 时间戳为item中offset处的int64纳秒
+    // 距离目标时间较远时先sleep, 最后一段用TSC自旋, 每条消息记录实际发布时间与目标时间的偏差
+    class Replayer {
+    private:
+        TscClock clock_;
+        double speed_ = 1.0;
+        int64_t spin_ns_ = 200000;//最后多少纳秒自旋
+
+    public:
+        Replayer() {
+            clock_.Calibrate();
+        }
+
+        // 2表示以两倍速回放
+        void SetSpeed(const double &speed) {
+            speed_ = speed > 0 ? speed : 1.0;
+        }
+
+        void SetSpinNanos(const int64_t &spin_ns) {
+            spin_ns_ = spin_ns;
+        }
+
+        // 回放[begin, end), 对每条消息按时间调用publish(item)
+        template<typename Func>
+        ReplayReport Replay(const Journal &journal, const size_t &timestamp_offset, const size_t &begin, const size_t &end, Func &&publish) {
+            ReplayReport report{};
+            if (begin >= end || timestamp_offset + sizeof(int64_t) > journal.ItemSize()) {
+                SPDLOG_ERROR("Bad replay range [{}, {}) or timestamp offset {}.", begin, end, timestamp_offset);
+                return report;
+            }
+
+            std::vector<int64_t> drifts;
+            drifts.reserve(end - begin);
+            int64_t first_timestamp;
+            memcpy(&first_timestamp, journal.Item(begin) + timestamp_offset, sizeof(int64_t));
+            const uint64_t start = TscClock::Ticks();
+            for (auto idx = begin; idx < end; idx++) {
+                const char *item = journal.Item(idx);
+                int64_t timestamp;
+                memcpy(&timestamp, item + timestamp_offset, sizeof(int64_t));
+                const uint64_t target = start + clock_.FromNanos(std::max<int64_t>(timestamp - first_timestamp, 0) / speed_);
+
+                //sleep --> spin
+                uint64_t now = TscClock::Ticks();
+                if (now < target && clock_.ToNanos(target - now) > spin_ns_) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds((int64_t) clock_.ToNanos(target - now) - spin_ns_));
+                }
+                while ((now = TscClock::Ticks()) < target) {
+#if defined(__x86_64__)
+                    _mm_pause();
+#endif
+                }
+                publish(item);
+                drifts.push_back((int64_t) clock_.ToNanos((int64_t) (now - target)));
+            }
+
+            report.elapsed = clock_.ToNanos(TscClock::Ticks() - start) / 1e9;
+            report.count = drifts.size();
+            double sum = 0;
+            for (auto drift: drifts) {
+                sum += drift;
+            }
+            report.mean = sum / drifts.size();
+            std::sort(drifts.begin(), drifts.end());
+            report.p50 = drifts[drifts.size() / 2];
+            report.p99 = drifts[drifts.size() * 99 / 100];
+            report.p999 = drifts[drifts.size() * 999 / 1000];
+            report.max = drifts.back();
+            return report;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_REPLAY_H
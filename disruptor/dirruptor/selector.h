@@ -0,0 +1,136 @@
+#ifndef MULTI_SHM_QUEUE_SELECTOR_H
+#define MULTI_SHM_QUEUE_SELECTOR_H
+
+#include "spmc.h"
+#include <thread>
+#include <vector>
+
+
+namespace disruptor {
+    // 每个数据源的统计
+    struct SelectorStats {
+        size_t polls;      //读取浮标的次数
+        size_t idle_polls; //读取浮标但没有新数据的次数
+        size_t batches;    //交给handler的批次数
+        size_t items;      //交给handler的item数量
+    };
+
+    // 一个消费线程读取多个Notebook, disruptor::Notebook和atomic_disruptor::Notebook都可以加入
+    // 每一轮按顺序轮询各个数据源, 每个数据源每轮最多读取weight * batch_size条, 轮询起点逐轮后移
+    // 没有新数据的数据源按指数退避, 之后若干轮不再读取它的浮标, 有数据后立即恢复每轮读取
+    class Selector {
+    private:
+        struct Source {
+            void *notebook;                  //数据源
+            size_t (*cursor)(void *notebook);//读取已提交数量
+            size_t weight;                   //每轮的配额倍数
+            size_t position;                 //下一个待读取的位置
+            size_t cursor_cache;             //上次读取的浮标, 未读完之前不再读取浮标
+            size_t idle_skip;                //退避轮数
+            size_t skip_left;                //还需要跳过的轮数
+            SelectorStats stats;
+        };
+
+        std::vector<Source> sources_;
+        size_t batch_size_ = 64;
+        size_t max_idle_skip_ = 16;
+        size_t start_ = 0;//本轮轮询起点
+
+    public:
+        Selector() = default;
+        ~Selector() = default;
+
+        // 加入数据源, 从position开始读取, 返回数据源编号
+        template<typename Book>
+        size_t Add(Book &notebook, const size_t &weight = 1, const size_t &position = 0) {
+            Source source{};
+            source.notebook = &notebook;
+            source.cursor = [](void *p) { return ((Book *) p)->GetCursor(); };
+            source.weight = std::max<size_t>(weight, 1);
+            source.position = position;
+            source.cursor_cache = position;
+            sources_.push_back(source);
+            return sources_.size() - 1;
+        }
+
+        // 每个数据源每轮最多读取weight * batch_size条
+        void SetBatchSize(const size_t &batch_size) {
+            batch_size_ = std::max<size_t>(batch_size, 1);
+        }
+
+        // 空闲数据源最多跳过多少轮, 0表示每轮都读取浮标
+        void SetIdleBackoff(const size_t &max_idle_skip) {
+            max_idle_skip_ = max_idle_skip;
+        }
+
+        // 轮询一轮, 对每个有新数据的数据源调用handler(source, begin, end), 返回本轮读取的item数量
+        template<typename Func>
+        size_t Poll(Func &&handler) {
+            size_t total = 0;
+            const size_t source_num = sources_.size();
+            for (size_t i = 0; i < source_num; i++) {
+                const size_t id = (start_ + i) % source_num;
+                auto &source = sources_[id];
+                if (source.position >= source.cursor_cache) {
+                    if (source.skip_left > 0) {
+                        source.skip_left--;
+                        continue;
+                    }
+                    source.cursor_cache = source.cursor(source.notebook);
+                    source.stats.polls++;
+                    if (source.position >= source.cursor_cache) {
+                        source.stats.idle_polls++;
+                        source.idle_skip = std::min(std::max<size_t>(source.idle_skip * 2, 1), max_idle_skip_);
+                        source.skip_left = source.idle_skip;
+                        continue;
+                    }
+                    source.idle_skip = 0;
+                }
+
+                const size_t begin = source.position;
+                const size_t end = std::min(source.cursor_cache, begin + source.weight * batch_size_);
+                source.position = end;
+                source.stats.batches++;
+                source.stats.items += end - begin;
+                total += end - begin;
+                handler(id, begin, end);
+            }
+            if (source_num > 0) {
+                start_ = (start_ + 1) % source_num;
+            }
+            return total;
+        }
+
+        // 轮询直到至少一个数据源有新数据, 返回读取的item数量
+        template<typename Func>
+        size_t Select(Func &&handler) {
+            int nCounter = 100;
+            while (true) {
+                if (auto n = Poll(handler); n > 0) {
+                    return n;
+                }
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        // 下一个待读取的位置
+        size_t Position(const size_t &source) const {
+            return sources_[source].position;
+        }
+
+        const SelectorStats &GetStats(const size_t &source) const {
+            return sources_[source].stats;
+        }
+
+        size_t Size() const {
+            return sources_.size();
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_SELECTOR_H
@@ -0,0 +1,113 @@
+#ifndef MULTI_SHM_QUEUE_SEQUENCER_H
+#define MULTI_SHM_QUEUE_SEQUENCER_H
+
+#include "spmc.h"
+#include <vector>
+
+
+namespace disruptor {
+    // 全局顺序中的一条消息, 只记录消息在输入Notebook中的位置, 不复制消息
+    struct Sequenced {
+        uint32_t source;     //输入Notebook编号, 即Add的顺序
+        uint32_t reserved;
+        uint64_t index;      //消息在输入Notebook中的位置
+        uint64_t global_seq; //全局序号, 即在输出Notebook中的位置
+        int64_t timestamp;   //定序时间, 纳秒
+    };
+
+    // 全局定序, 按编号顺序轮流批量读取多个输入Notebook, 为每条消息分配全局序号和时间, 写入输出Notebook
+    // 下游消费者和回放都读取输出Notebook, 看到同一个全序; 定序结果只取决于输出Notebook, 重启后可以接着定序
+    template<typename Book, typename OutBook = Notebook<Sequenced>>
+    class Sequencer {
+    private:
+        std::vector<Book *> inputs_;
+        std::vector<size_t> positions_;//每个输入下一个待定序的位置
+        OutBook &output_;
+        size_t batch_size_ = 64;
+
+    public:
+        explicit Sequencer(OutBook &output) : output_(output) {}
+        ~Sequencer() = default;
+
+        // 加入输入Notebook, 返回编号; 输入的编号必须在每次启动时保持一致
+        size_t Add(Book &notebook) {
+            inputs_.push_back(&notebook);
+            positions_.push_back(0);
+            return inputs_.size() - 1;
+        }
+
+        // 每个输入每轮最多定序多少条
+        void SetBatchSize(const size_t &batch_size) {
+            batch_size_ = std::max<size_t>(batch_size, 1);
+        }
+
+        // 重启后从输出Notebook末尾向前查找每个输入最后定序的位置
+        void Resume() {
+            std::vector<bool> found(inputs_.size(), false);
+            size_t left = inputs_.size();
+            for (size_t seq = output_.GetCursor(); seq > 0 && left > 0; seq--) {
+                auto descriptor = output_.GetData(seq - 1);
+                if (descriptor->source < inputs_.size() && !found[descriptor->source]) {
+                    found[descriptor->source] = true;
+                    positions_[descriptor->source] = descriptor->index + 1;
+                    left--;
+                }
+            }
+            SPDLOG_INFO("Sequencer resume, global_seq:{}.", output_.GetCursor());
+        }
+
+        // 定序一轮, 返回定序的消息数量
+        size_t Poll() {
+            size_t total = 0;
+            for (size_t source = 0; source < inputs_.size(); source++) {
+                const size_t begin = positions_[source];
+                const size_t end = std::min(inputs_[source]->GetCursor(), begin + batch_size_);
+                if (begin >= end) {
+                    continue;
+                }
+                const int64_t timestamp = NowNanos();
+                for (auto idx = begin; idx < end; idx++) {
+                    auto descriptor = output_.OpenData();
+                    descriptor->source = source;
+                    descriptor->reserved = 0;
+                    descriptor->index = idx;
+                    descriptor->global_seq = output_.GetCursor();
+                    descriptor->timestamp = timestamp;
+                    output_.Commit();
+                }
+                positions_[source] = end;
+                total += end - begin;
+            }
+            return total;
+        }
+
+        // 定序直到stop为true
+        void Run(const std::atomic<bool> &stop) {
+            int nCounter = 100;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (Poll() > 0) {
+                    nCounter = 100;
+                    continue;
+                }
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        // 按描述取得输入Notebook中的消息
+        auto GetData(const Sequenced &descriptor) {
+            return inputs_[descriptor.source]->GetData(descriptor.index);
+        }
+
+        // 该输入下一个待定序的位置
+        size_t Position(const size_t &source) const {
+            return positions_[source];
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_SEQUENCER_H
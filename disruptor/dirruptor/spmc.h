@@ -5,8 +5,17 @@
 #ifndef MULTI_SHM_QUEUE_SPMC_H
 #define MULTI_SHM_QUEUE_SPMC_H
 
+#include "copy.h"
+#include "geometry.h"
+#include "header.h"
+#include "numa.h"
 #include "spdlog/spdlog.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <cstdio>
 #include <cstring>
 #include <fcntl.h>
@@ -17,29 +26,60 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
 
-inline bool cpu_set_affinity(int cpu_id) {
-#if defined __linux__
-    cpu_set_t mask;
-    CPU_ZERO(&mask);
-    CPU_SET(cpu_id, &mask);
-    return 0 == sched_setaffinity(0, sizeof(mask), &mask);
-#else
-    return false;
-#endif
-}
+namespace disruptor {
+    static constexpr size_t kMaxConsumers = 32;//最多登记多少个消费者
+    static constexpr size_t kMaxSamples = 64;  //生产者保留多少个位置采样
+    static constexpr int64_t kSampleInterval = 100 * 1000 * 1000;//位置采样间隔, 纳秒
+    static constexpr int64_t kAliveInterval = 100 * 1000 * 1000; //消费者存活检查的缓存时间, 纳秒
+
+    // 心跳和位置, 由生产者或消费者自己更新, 监控工具只读; 各自独占cache line, 不与cursor伪共享
+    struct alignas(64) Heartbeat {
+        std::atomic<pid_t> pid;       //所属进程, 0表示空闲
+        char name[28];                //消费者名称
+        std::atomic<int64_t> time;    //最近一次心跳, 纳秒
+        std::atomic<size_t> position; //生产者为已写入位置, 消费者为已读取位置
+        std::atomic<size_t> stalls;   //进入等待的次数
+        std::atomic<size_t> committed;//消费者已处理完的位置, 重启后从这里继续
+    };
 
+    // 生产者定期记录的位置和时间, 用于估算消费者落后的时间
+    struct Sample {
+        std::atomic<size_t> cursor;
+        std::atomic<int64_t> time;
+    };
 
-namespace disruptor {
     // 共享内存写入和读取的浮标
     struct Bookmark {
-        size_t item_num;//存入结构体数量
-        size_t page_num;// 使用page数量
-        size_t cursor;  //浮标，已写入位置
-                        //        size_t next;    //浮标，下次写入位置
+        Header header;                      //描述信息，存入结构体数量、page数量等
+        size_t cursor;                      //浮标，已写入位置
+        Heartbeat producer;                 //生产者心跳
+        std::atomic<size_t> sample_num;     //位置采样总数
+        Sample samples[kMaxSamples];        //最近的位置采样
+        Heartbeat consumers[kMaxConsumers]; //消费者心跳
     };
 
+    inline int64_t NowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+    }
+
+    inline bool ProcessAlive(const pid_t &pid) {
+        return kill(pid, 0) == 0 || errno == EPERM;
+    }
+
+    inline void ResetHeartbeat(Heartbeat &heartbeat) {
+        heartbeat.pid.store(0);
+        memset(heartbeat.name, 0, sizeof(heartbeat.name));
+        heartbeat.time.store(0);
+        heartbeat.position.store(0);
+        heartbeat.stalls.store(0);
+        heartbeat.committed.store(0);
+    }
+
     class Page {
     public:
         static constexpr int KB = 1024;
@@ -56,16 +96,46 @@ namespace disruptor {
             return true;
         }
 
+        // madvise, 地址向下对齐到系统页
+        static bool Advise(void *address, size_t length, int advice) {
+            static const size_t os_page_size = sysconf(_SC_PAGESIZE);
+            auto begin = (uintptr_t) address & ~(os_page_size - 1);
+            length += (uintptr_t) address - begin;
+            if (madvise((void *) begin, length, advice) != 0) {
+                SPDLOG_ERROR("Failed to madvise: {}, size: {}, advice: {}, errno: {}", address, length, advice, strerror(errno));
+                return false;
+            }
+            return true;
+        }
+
+        // 映射文件开头length字节, 读取方用来写书签中的消费者信息, 监控工具用来只读书签
+        static void *Map(const std::string &path, const size_t &length, const bool &writable) {
+            int fd = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+            if (fd == -1) {
+                SPDLOG_ERROR("Open error: {}, path: {}", strerror(errno), path);
+                return nullptr;
+            }
+            void *data = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) {
+                SPDLOG_ERROR("Failed to mmap: {}, size: {}, errno: {}", path, length, strerror(errno));
+                return nullptr;
+            }
+            return data;
+        }
+
     private:
         std::string file_path_;
         bool write_mode_;
+        size_t size_;
         void *data_ = nullptr;
 
     public:
-        Page(const std::string &file_path, const bool &write_mode) {
+        Page(const std::string &file_path, const bool &write_mode, const size_t &size = page_size) {
             file_path_ = file_path;
             write_mode_ = write_mode;
-            SPDLOG_DEBUG("Page, path:{}, mode:{}.", file_path_, write_mode_);
+            size_ = size;
+            SPDLOG_DEBUG("Page, path:{}, mode:{}, size:{}.", file_path_, write_mode_, size_);
         }
         ~Page() {
             SPDLOG_DEBUG("~Page, path:{}, mode:{}.", file_path_, write_mode_);
@@ -90,28 +160,28 @@ namespace disruptor {
 
             // 改变文件大小
             if (st.st_size == 0) {
-                if (ftruncate(fd, (int64_t) page_size) == 0) {
-                    SPDLOG_DEBUG("Ftruncate, file size:{}", page_size);
+                if (ftruncate(fd, (int64_t) size_) == 0) {
+                    SPDLOG_DEBUG("Ftruncate, file size:{}", size_);
                 } else {
-                    SPDLOG_ERROR("Failed to ftruncate {}, size:{}, error:{}", file_path_, page_size, strerror(errno));
+                    SPDLOG_ERROR("Failed to ftruncate {}, size:{}, error:{}", file_path_, size_, strerror(errno));
                     return false;
                 }
             } else {
                 SPDLOG_DEBUG("File exit,  path:{}, size:{}.", file_path_, st.st_size);
-                if (st.st_size != page_size) {
+                if ((size_t) st.st_size != size_) {
                     SPDLOG_ERROR("File exit,  path:{}, size:{}.", file_path_, st.st_size);
                     return false;
                 }
             }
 
             if (write_mode_) {
-                data_ = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
             } else {
-                data_ = mmap(nullptr, page_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
             }
 
             if (data_ == MAP_FAILED) {
-                SPDLOG_ERROR("Failed to mmap: {}, size: {}, errno: {}", file_path_, page_size, strerror(errno));
+                SPDLOG_ERROR("Failed to mmap: {}, size: {}, errno: {}", file_path_, size_, strerror(errno));
                 close(fd);
                 return false;
             } else {
@@ -121,13 +191,13 @@ namespace disruptor {
         }
 
         bool DetachShm() {
-            if (msync(data_, page_size, MS_SYNC) != 0) {
-                SPDLOG_ERROR("Failed to msync: {}, size: {}, errno: {}", file_path_, page_size, strerror(errno));
+            if (msync(data_, size_, MS_SYNC) != 0) {
+                SPDLOG_ERROR("Failed to msync: {}, size: {}, errno: {}", file_path_, size_, strerror(errno));
                 return false;
             }
 
-            if (munmap(data_, page_size) == -1) {
-                SPDLOG_ERROR("Failed to munmap: {}, size: {}, errno: {}", file_path_, page_size, strerror(errno));
+            if (munmap(data_, size_) == -1) {
+                SPDLOG_ERROR("Failed to munmap: {}, size: {}, errno: {}", file_path_, size_, strerror(errno));
                 return false;
             }
             data_ = nullptr;
@@ -141,12 +211,15 @@ namespace disruptor {
         void *GetShmDataAddress() { return data_; }
 
         auto GetFilePath() { return file_path_; }
+
+        size_t GetSize() const { return size_; }
     };
 
 
     class WaitStrategy {
     private:
         Bookmark *bookmark_{};
+        Heartbeat *heartbeat_{};//已登记的消费者, 记录等待次数
 
     public:
         explicit WaitStrategy(Bookmark *ptr) {
@@ -155,7 +228,14 @@ namespace disruptor {
 
         ~WaitStrategy() = default;
 
+        void SetHeartbeat(Heartbeat *ptr) {
+            heartbeat_ = ptr;
+        }
+
         size_t Wait(const size_t &idx) {
+            if (heartbeat_ != nullptr) {
+                heartbeat_->stalls.fetch_add(1, std::memory_order_relaxed);
+            }
             int nCounter = 100;
             while (true) {
                 const size_t current_cursor = bookmark_->cursor;
@@ -174,133 +254,302 @@ namespace disruptor {
         }
     };
 
-    template<typename T>
+    // Capacity为0时item数量由Init参数确定, 否则在编译期确定, item定位全部为常量运算
+    template<typename T, size_t Capacity = 0, size_t PageSize = Page::page_size>
     class Notebook {
+    public:
+        using Layout = Geometry<sizeof(T), sizeof(Bookmark), PageSize, Capacity>;
+
     private:
+        std::string folder_path_;
         size_t capacity_{};           //有多少item
-        std::vector<T *> content_;    //目录，指向所有item的内存地址
+        std::vector<char *> pages_;   //所有page的映射地址
         Bookmark *bookmark_ = nullptr;//书签
         WaitStrategy *wait_ = nullptr;
-
-        bool SetCapacity(const size_t &capacity) {
-            try {
-                content_.reserve(capacity + 1024);
-            } catch (const std::length_error &e) {
-                SPDLOG_ERROR("SetCapacity Error: {}.", e.what());
-                return false;
+        Heartbeat *consumer_ = nullptr;//已登记的消费者
+        Bookmark *consumer_mark_ = nullptr;//登记消费者时可写映射的书签, 析构时解除映射
+        size_t checkpoint_interval_ = 0;//批量读取时每处理多少个item保存一次位置, 0不保存
+
+        size_t prefetch_distance_ = 0;//批量读取时提前预取多少个item, 0不预取
+        size_t advise_window_ = 0;    //批量读取时提前WILLNEED多少字节
+        char *advised_ = nullptr;     //已经WILLNEED到的地址
+        size_t advised_page_ = -1;    //advised_所在page
+
+        size_t release_window_ = 0;        //批量读取时每消费多少字节释放一次, 0不释放
+        int release_advice_ = MADV_DONTNEED;//MADV_DONTNEED或MADV_COLD
+        size_t released_ = 0;              //已释放到的item位置
+
+        mutable std::array<pid_t, kMaxConsumers> alive_pid_{};//上次检查时存活的消费者进程
+        mutable int64_t alive_time_ = 0;                      //上次检查存活的时间
+
+        // 映射page, 从已映射的page数量开始
+        bool MapPages(const std::string &folder_path, const size_t &page_num, const bool &writer) {
+            pages_.reserve(page_num);
+            for (size_t p = pages_.size(); p < page_num; p++) {
+                std::string file_path = folder_path + "_page_" + std::to_string(p) + ".store";
+                auto page = Page(file_path, writer, PageSize);
+                if (!page.GetShm()) {
+                    return false;
+                }
+                pages_.push_back((char *) page.GetShmDataAddress());
             }
-            capacity_ = capacity;
             return true;
         }
 
-    public:
-        Notebook() = default;
-        ~Notebook() = default;
-
-        bool Init(const std::string &folder_path, const size_t &item_num, const bool &writer, const bool &init, const int &cpu_id = 1) {
-            // cpu亲和力
-            if (cpu_id > 0) {
-                if (cpu_set_affinity(cpu_id)) {
-                    SPDLOG_INFO("Set cpu_id {} successfully.", cpu_id);
-                } else {
-                    SPDLOG_INFO("Set cpu_id {} failed.", cpu_id);
+        void UnmapConsumerMark() {
+            if (consumer_mark_ != nullptr) {
+                if (consumer_ != nullptr) {
+                    wait_->SetHeartbeat(nullptr);
+                    consumer_ = nullptr;
                 }
+                munmap(consumer_mark_, sizeof(Bookmark));
+                consumer_mark_ = nullptr;
             }
+        }
+
+        T *Address(const size_t &idx) const {
+            if constexpr (Layout::page_num == 1) {
+                return (T *) (pages_[0] + Layout::OffsetOf(idx));
+            } else {
+                return (T *) (pages_[Layout::PageOf(idx)] + Layout::OffsetOf(idx));
+            }
+        }
 
-            if (!SetCapacity(item_num)) {
+    public:
+        Notebook() = default;
+        ~Notebook() {
+            UnmapConsumerMark();
+        }
+
+        // 不再设置cpu亲和力, 线程放置见placement.h
+        bool Init(const std::string &folder_path, const size_t &item_num, const bool &writer, const bool &init) {
+            if (Capacity > 0 && item_num != Capacity) {
+                SPDLOG_ERROR("Item num {} does not match capacity {}.", item_num, Capacity);
                 return false;
             }
+            capacity_ = item_num;
 
-            const size_t item_size = sizeof(T);                              //结构体大小
-            const size_t item_num_in_mark = sizeof(Bookmark) / item_size + 1;//书签相当于多少个结构体
-            const size_t total_item_num = item_num + item_num_in_mark;       //书签和结构体加总相当于多少个item结构体的空间占用
-            const size_t item_num_in_page = Page::page_size / item_size - 1; //一页能装下多少item
-            const size_t page_num = total_item_num / item_num_in_page + 1;   //需要多少page才能全部装下
-            size_t idx = 0;                                                  //目录索引，对应读取写入游标
+            const size_t page_num = Layout::PageNum(item_num);//需要多少page才能全部装下
             SPDLOG_DEBUG("params.");
-            SPDLOG_DEBUG("item_size:{}", item_size);
+            SPDLOG_DEBUG("item_size:{}", sizeof(T));
             SPDLOG_DEBUG("item_num:{}", item_num);
             SPDLOG_DEBUG("mark_size:{}", sizeof(Bookmark));
-            SPDLOG_DEBUG("item_num_in_mark:{}", item_num_in_mark);
-            SPDLOG_DEBUG("item_num_in_page:{}", item_num_in_page);
+            SPDLOG_DEBUG("item_num_in_mark:{}", Layout::item_num_in_mark);
+            SPDLOG_DEBUG("item_num_in_page:{}", Layout::item_num_in_page);
             SPDLOG_DEBUG("page_num:{}", page_num);
-            SPDLOG_DEBUG("page_size:{}", Page::page_size);
-            SPDLOG_DEBUG("total_item_num:{}", total_item_num);
-            SPDLOG_DEBUG("item_num_in_all_page:{}", item_num_in_page * page_num);
-
-            // 创建第一个Page，书签Bookmark也在这个页面上面
-            {
-                std::string file_path = folder_path + "_page_0.store";
-                auto page = Page(file_path, writer);
-                if (!page.GetShm()) {
-                    return false;
-                }
+            SPDLOG_DEBUG("page_size:{}", PageSize);
+            SPDLOG_DEBUG("power_of_two:{}", Layout::power_of_two);
 
-                // 书签
-                bookmark_ = (Bookmark *) page.GetShmDataAddress();
-                wait_ = new WaitStrategy(bookmark_);
-                if (init) {
-                    bookmark_->item_num = item_num;
-                    bookmark_->page_num = page_num;
-                    bookmark_->cursor = 0;
-                    //                    bookmark_->next = -1;
-                }
+            pages_.clear();
+            if (!MapPages(folder_path, page_num, writer)) {
+                return false;
+            }
 
-                // 只使用一个页面
-                if (page_num == 1) {
-                    for (auto i = 0; i < item_num; i++) {
-                        content_[i] = (T *) ((char *) page.GetShmDataAddress() + sizeof(Bookmark) + sizeof(T) * i);
-                    }
-                    return true;
+            // 书签在第一个Page开头
+            bookmark_ = (Bookmark *) pages_[0];
+            wait_ = new WaitStrategy(bookmark_);
+            const auto expected = MakeHeader<T, Layout>(item_num, PageSize, sizeof(Bookmark));
+            if (init) {
+                bookmark_->header = expected;
+                bookmark_->cursor = 0;
+                ResetHeartbeat(bookmark_->producer);
+                bookmark_->sample_num.store(0);
+                for (auto &consumer: bookmark_->consumers) {
+                    ResetHeartbeat(consumer);
                 }
+            } else if (!CheckHeader(bookmark_->header, expected)) {
+                return false;
+            }
+            if (writer) {
+                bookmark_->producer.pid.store(getpid());
+            }
+            folder_path_ = folder_path;
+            return true;
+        }
 
-                //使用多个页面
-                for (auto i = 0; i < item_num_in_page - item_num_in_mark; i++) {
-                    content_[idx++] = (T *) ((char *) page.GetShmDataAddress() + sizeof(Bookmark) + sizeof(T) * i);
-                }
+        // 只根据路径加载已经init过的Notebook, 容量和page数量从page0的描述信息读取
+        bool Attach(const std::string &folder_path, const bool &writer = false) {
+            pages_.clear();
+            if (!MapPages(folder_path, 1, writer)) {
+                return false;
             }
 
-            //Pages
-            for (auto p = 1; p < page_num; p++) {
-                std::string file_path = folder_path + "_page_" + std::to_string(p) + ".store";
-                auto page = Page(file_path, writer);
-                if (!page.GetShm()) {
-                    return false;
+            bookmark_ = (Bookmark *) pages_[0];
+            const Header &header = bookmark_->header;
+            if (!CheckHeader(header, MakeHeader<T, Layout>(Capacity, PageSize, sizeof(Bookmark)))) {
+                return false;
+            }
+            capacity_ = Capacity > 0 ? Capacity : header.item_num;
+            if (!MapPages(folder_path, Capacity > 0 ? Layout::page_num : header.page_num, writer)) {
+                return false;
+            }
+            wait_ = new WaitStrategy(bookmark_);
+            if (writer) {
+                bookmark_->producer.pid.store(getpid());
+            }
+            folder_path_ = folder_path;
+            SPDLOG_DEBUG("Attach, path:{}, item_num:{}, page_num:{}, create_time:{}.",
+                         folder_path, header.item_num, header.page_num, header.create_time);
+            return true;
+        }
+
+        const Header &GetHeader() const {
+            return bookmark_->header;
+        }
+
+        // 生产者心跳, 定期调用, 同时每隔kSampleInterval记录一次位置采样
+        void Beat() {
+            const int64_t now = NowNanos();
+            const size_t cursor = bookmark_->cursor;
+            bookmark_->producer.position.store(cursor, std::memory_order_relaxed);
+            bookmark_->producer.time.store(now, std::memory_order_relaxed);
+
+            const size_t sample_num = bookmark_->sample_num.load(std::memory_order_relaxed);
+            if (sample_num == 0 || now - bookmark_->samples[(sample_num - 1) % kMaxSamples].time.load() >= kSampleInterval) {
+                auto &sample = bookmark_->samples[sample_num % kMaxSamples];
+                sample.cursor.store(cursor, std::memory_order_relaxed);
+                sample.time.store(now, std::memory_order_relaxed);
+                bookmark_->sample_num.store(sample_num + 1, std::memory_order_release);
+            }
+        }
+
+        // 消费者心跳, idx为已读取位置
+        // position使用release, 生产者按位置回收arena等共享数据时, 消费者对这些数据的读取已经完成
+        void Beat(const size_t &idx) {
+            if (consumer_ != nullptr) {
+                consumer_->position.store(idx, std::memory_order_release);
+                consumer_->time.store(NowNanos(), std::memory_order_relaxed);
+            }
+        }
+
+        // 保存已处理完的位置, 位置在共享的书签中, 进程退出后仍然保留
+        void Checkpoint(const size_t &idx) {
+            if (consumer_ != nullptr) {
+                consumer_->committed.store(idx, std::memory_order_release);
+            }
+        }
+
+        // 批量读取时每处理interval个item自动保存一次位置, handler返回即视为处理完
+        void SetCheckpointInterval(const size_t &interval) {
+            checkpoint_interval_ = interval;
+        }
+
+        // 返回上次保存的位置, 即下一个待读取的位置; 需要先用同一个名字RegisterConsumer
+        size_t ResumeFromCheckpoint() {
+            if (consumer_ == nullptr) {
+                SPDLOG_ERROR("Consumer is not registered.");
+                return 0;
+            }
+            const size_t committed = consumer_->committed.load(std::memory_order_acquire);
+            consumer_->position.store(committed, std::memory_order_release);
+            released_ = committed;
+            SPDLOG_INFO("Resume consumer {} from {}.", consumer_->name, committed);
+            return committed;
+        }
+
+        // 所有存活消费者中最小的已读取位置, 没有存活消费者时为已写入位置
+        // 存活检查每kAliveInterval做一次, 其间只对新出现的消费者进程调用kill, 适合在等待空间的循环中调用
+        size_t MinConsumerPosition() const {
+            const int64_t now = NowNanos();
+            const bool refresh = now - alive_time_ >= kAliveInterval;
+            if (refresh) {
+                alive_time_ = now;
+            }
+            size_t min_position = bookmark_->cursor;
+            for (size_t i = 0; i < kMaxConsumers; i++) {
+                auto &consumer = bookmark_->consumers[i];
+                const pid_t pid = consumer.pid.load(std::memory_order_relaxed);
+                if (consumer.name[0] == 0 || pid == 0) {
+                    continue;
+                }
+                if (refresh || alive_pid_[i] != pid) {
+                    alive_pid_[i] = ProcessAlive(pid) ? pid : 0;
+                }
+                if (alive_pid_[i] == pid) {
+                    min_position = std::min(min_position, consumer.position.load(std::memory_order_acquire));
                 }
+            }
+            return min_position;
+        }
 
-                auto left_item_num =
-                        total_item_num - (item_num_in_page - item_num_in_mark) - item_num_in_page * (p - 1);
-                if (left_item_num < item_num_in_page) {
-                    for (auto i = 0; i < left_item_num; i++) {
-                        content_[idx++] = (T *) ((char *) page.GetShmDataAddress() + sizeof(T) * i);
+        // 登记消费者, 同名登记会被复用; 读取方需要以读写方式映射书签
+        bool RegisterConsumer(const std::string &name) {
+            if (name.empty() || name.size() >= sizeof(Heartbeat::name)) {
+                SPDLOG_ERROR("Bad consumer name: {}.", name);
+                return false;
+            }
+            UnmapConsumerMark();
+            auto bookmark = (Bookmark *) Page::Map(folder_path_ + "_page_0.store", sizeof(Bookmark), true);
+            if (bookmark == nullptr) {
+                return false;
+            }
+            consumer_mark_ = bookmark;
+
+            const pid_t self = getpid();
+            Heartbeat *heartbeat = nullptr;
+            for (auto &consumer: bookmark->consumers) {
+                if (strncmp(consumer.name, name.c_str(), sizeof(consumer.name)) == 0) {
+                    pid_t pid = consumer.pid.load();
+                    if (pid != 0 && pid != self && ProcessAlive(pid)) {
+                        SPDLOG_ERROR("Consumer {} is used by {}.", name, pid);
+                        UnmapConsumerMark();
+                        return false;
                     }
-                } else {
-                    for (auto i = 0; i < item_num_in_page; i++) {
-                        content_[idx++] = (T *) ((char *) page.GetShmDataAddress() + sizeof(T) * i);
+                    if (consumer.pid.compare_exchange_strong(pid, self)) {
+                        heartbeat = &consumer;
                     }
+                    break;
                 }
             }
+            for (auto &consumer: bookmark->consumers) {
+                if (heartbeat != nullptr) {
+                    break;
+                }
+                pid_t pid = 0;
+                if (consumer.name[0] == 0 && consumer.pid.compare_exchange_strong(pid, self)) {
+                    strncpy(consumer.name, name.c_str(), sizeof(consumer.name) - 1);
+                    consumer.position.store(0);
+                    consumer.stalls.store(0);
+                    consumer.committed.store(0);
+                    heartbeat = &consumer;
+                }
+            }
+            if (heartbeat == nullptr) {
+                SPDLOG_ERROR("Failed to register consumer {}, max:{}.", name, kMaxConsumers);
+                UnmapConsumerMark();
+                return false;
+            }
+
+            heartbeat->time.store(NowNanos());
+            consumer_ = heartbeat;
+            wait_->SetHeartbeat(heartbeat);
+            SPDLOG_INFO("Register consumer {}, pid:{}.", name, self);
             return true;
         }
 
-        //        size_t ClaimIndex() {
-        //            return bookmark_->next++ + 1;
-        //        };
-
         void SetData(const T &data) {
-            constexpr size_t item_size = sizeof(T);
-            memcpy(content_[bookmark_->cursor], &data, item_size);
+            CopyItem<sizeof(T)>(Address(bookmark_->cursor), &data);
             bookmark_->cursor++;
         }
 
         T *OpenData() {
-            return content_[bookmark_->cursor];
+            return Address(bookmark_->cursor);
+        }
+
+        // 已写入位置, 即下一次写入的位置
+        size_t GetCursor() const {
+            return bookmark_->cursor;
         }
 
         void Commit() {
             bookmark_->cursor++;
         };
 
+        // 一次提交OpenData之后连续写入的n个位置
+        void CommitBatch(const size_t &n) {
+            bookmark_->cursor += n;
+        }
+
         //consumer
         size_t WaitFor(const size_t &idx) {
             const size_t current_cursor = bookmark_->cursor;
@@ -312,7 +561,129 @@ namespace disruptor {
         }
 
         T *GetData(const size_t &idx) {
-            return content_[idx];
+            return Address(idx);
+        }
+
+        // 批量读取的预取设置, distance为提前预取的item数量, window为提前WILLNEED的字节数
+        void SetPrefetch(const size_t &distance, const size_t &window = 4 * Page::MB) {
+            prefetch_distance_ = distance;
+            advise_window_ = window;
+            advised_ = nullptr;
+            advised_page_ = -1;
+            if (window > 0) {
+                for (auto page: pages_) {
+                    Page::Advise(page, PageSize, MADV_SEQUENTIAL);
+                }
+            }
+        }
+
+        // 批量读取[begin, end), 返回下一个待读取的位置
+        template<typename Func>
+        size_t ForEach(const size_t &begin, const size_t &end, Func &&handler) {
+            for (auto idx = begin; idx < end; idx++) {
+                if (prefetch_distance_ > 0 && idx + prefetch_distance_ < end) {
+                    Prefetch(Address(idx + prefetch_distance_));
+                }
+                if (advise_window_ > 0) {
+                    AdviseAhead(idx);
+                }
+                handler(idx, Address(idx));
+            }
+            if (consumer_ != nullptr) {
+                consumer_->position.store(end, std::memory_order_release);
+                if (checkpoint_interval_ > 0 && end - consumer_->committed.load(std::memory_order_relaxed) >= checkpoint_interval_) {
+                    consumer_->committed.store(end, std::memory_order_release);
+                }
+            }
+            if (release_window_ > 0 && (end - released_) * sizeof(T) >= release_window_) {
+                Release(end);
+            }
+            return end;
+        }
+
+        // 设置所有page的NUMA内存策略, 在写入之前调用; policy为kMemBind, kMemInterleave等
+        // 书签所在的系统页已经写入, 会被迁移到指定节点
+        bool BindPages(const int &policy, const std::vector<int> &nodes) {
+            for (auto page: pages_) {
+                if (!BindMemory(page, PageSize, policy, nodes)) {
+                    return false;
+                }
+            }
+            SPDLOG_INFO("Bind {} pages, policy:{}, nodes:[{}].", pages_.size(), policy, FormatNodes(nodes));
+            return true;
+        }
+
+        // 每个page的系统页实际所在的NUMA节点
+        std::string ResidencyReport() const {
+            std::string out;
+            std::vector<size_t> total;
+            size_t total_absent = 0;
+            std::vector<size_t> nodes;
+            size_t absent = 0;
+            for (size_t p = 0; p < pages_.size(); p++) {
+                if (!Residency(pages_[p], PageSize, nodes, absent)) {
+                    return out;
+                }
+                out += fmt::format("page {}: {}\n", p, FormatResidency(nodes, absent));
+                total.resize(std::max(total.size(), nodes.size()), 0);
+                for (size_t node = 0; node < nodes.size(); node++) {
+                    total[node] += nodes[node];
+                }
+                total_absent += absent;
+            }
+            out += fmt::format("total: {}\n", FormatResidency(total, total_absent));
+            return out;
+        }
+
+        // 流式读取时释放已消费的内存, window为每消费多少字节释放一次
+        void SetRelease(const size_t &window, const int &advice = MADV_DONTNEED) {
+            release_window_ = window;
+            release_advice_ = advice;
+        }
+
+        // 释放[0, idx)所占用的完整系统页, 书签所在的系统页不释放
+        void Release(const size_t &idx) {
+            static const size_t os_page_size = sysconf(_SC_PAGESIZE);
+            auto p = Layout::PageOf(released_);
+            while (released_ < idx && p < pages_.size()) {
+                const size_t page_end_idx = p + 1 < pages_.size() ? Layout::FirstIndexOf(p + 1) : capacity_;
+                const size_t stop = std::min(idx, page_end_idx);
+
+                auto begin = (uintptr_t) Address(released_) & ~(os_page_size - 1);
+                if (p == 0) {
+                    begin = std::max(begin, (uintptr_t) pages_[0] + os_page_size);
+                }
+                auto end = stop == page_end_idx ? (uintptr_t) pages_[p] + PageSize
+                                                : (uintptr_t) Address(stop) & ~(os_page_size - 1);
+                if (begin < end) {
+                    Page::Advise((void *) begin, end - begin, release_advice_);
+                }
+                released_ = stop;
+                p++;
+            }
+        }
+
+    private:
+        static void Prefetch(const T *item) {
+            for (size_t offset = 0; offset < sizeof(T); offset += 64) {
+                __builtin_prefetch((const char *) item + offset, 0, 3);
+            }
+        }
+
+        // 读取位置接近已WILLNEED的末尾时, 对后续一个窗口发出WILLNEED, 不跨越page映射
+        void AdviseAhead(const size_t &idx) {
+            const size_t p = Layout::PageOf(idx);
+            auto address = (char *) Address(idx);
+            if (p == advised_page_ && address + advise_window_ / 2 < advised_) {
+                return;
+            }
+            auto begin = (p == advised_page_ && advised_ > address) ? advised_ : address;
+            auto end = std::min(address + advise_window_, pages_[p] + PageSize);
+            if (begin < end) {
+                Page::Advise(begin, end - begin, MADV_WILLNEED);
+            }
+            advised_page_ = p;
+            advised_ = end;
         }
     };
 }// namespace disruptor
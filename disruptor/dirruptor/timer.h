@@ -0,0 +1,221 @@
+#ifndef MULTI_SHM_QUEUE_TIMER_H
+#define MULTI_SHM_QUEUE_TIMER_H
+
+#include "claim.h"
+#include "spmc.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+
+namespace disruptor {
+    // 分层时间轮, 保存定时消息, 到期时写入目标Notebook
+    // 由消费循环或者专门的线程调用Advance驱动, 同一个tick到期的消息按登记顺序写入连续的位置, 一次提交
+    // 第l层每个slot覆盖Slots^l个tick, 低层转完一圈时把高层对应slot中的消息重新分配到低层
+    // 登记和取消都是O(1), 消息保存在进程内存中, 不在共享内存中
+    template<typename T, typename Book, size_t SlotBits = 8, size_t Levels = 4>
+    class TimerWheel {
+        static constexpr size_t kSlots = size_t(1) << SlotBits;
+        static constexpr size_t kMask = kSlots - 1;
+        static constexpr uint32_t kNil = -1;
+
+        struct Entry {
+            T data;
+            int64_t due;         //到期tick
+            uint32_t prev;       //同一slot中的前一个
+            uint32_t next;       //同一slot中的后一个, 或者空闲链表的下一个
+            uint32_t slot;       //所在slot
+            uint32_t generation; //复用时递增, 取消时校验
+            bool active;
+        };
+
+    private:
+        Book &notebook_;
+        int64_t tick_ns_;       //tick长度, 纳秒
+        int64_t start_;         //tick 0的时间, 纳秒
+        int64_t current_ = 0;   //下一个待处理的tick
+        std::vector<Entry> entries_;
+        uint32_t free_ = kNil;  //空闲链表
+        size_t size_ = 0;       //等待中的消息数量
+        std::array<size_t, Levels> count_{};//每层的消息数量
+        std::array<uint32_t, Levels * kSlots> head_;
+        std::array<uint32_t, Levels * kSlots> tail_;
+
+        void Link(const uint32_t &id) {
+            auto &entry = entries_[id];
+            const int64_t delta = entry.due - current_;
+            size_t level = 0;
+            while (level + 1 < Levels && delta >= (int64_t(1) << (SlotBits * (level + 1)))) {
+                level++;
+            }
+            // 超出最高层范围的消息放在最高层最远的slot, 重新分配时再按实际到期时间放置
+            const int64_t max_due = current_ + (int64_t(1) << (SlotBits * Levels)) - 1;
+            const int64_t due = std::max(std::min(entry.due, max_due), current_);
+            const uint32_t slot = level * kSlots + ((due >> (SlotBits * level)) & kMask);
+
+            entry.slot = slot;
+            count_[level]++;
+            entry.prev = tail_[slot];
+            entry.next = kNil;
+            if (tail_[slot] == kNil) {
+                head_[slot] = id;
+            } else {
+                entries_[tail_[slot]].next = id;
+            }
+            tail_[slot] = id;
+        }
+
+        void Unlink(const uint32_t &id) {
+            auto &entry = entries_[id];
+            count_[entry.slot / kSlots]--;
+            if (entry.prev == kNil) {
+                head_[entry.slot] = entry.next;
+            } else {
+                entries_[entry.prev].next = entry.next;
+            }
+            if (entry.next == kNil) {
+                tail_[entry.slot] = entry.prev;
+            } else {
+                entries_[entry.next].prev = entry.prev;
+            }
+        }
+
+        void Free(const uint32_t &id) {
+            auto &entry = entries_[id];
+            entry.active = false;
+            entry.generation++;
+            entry.next = free_;
+            free_ = id;
+            size_--;
+        }
+
+        // 取出整个slot, 返回链表头
+        uint32_t Take(const uint32_t &slot) {
+            const uint32_t id = head_[slot];
+            head_[slot] = kNil;
+            tail_[slot] = kNil;
+            return id;
+        }
+
+        // 处理tick current_, 先把高层到期的slot重新分配, 再写入第0层到期的消息
+        size_t Tick() {
+            for (size_t level = Levels - 1; level > 0; level--) {
+                if ((current_ & ((int64_t(1) << (SlotBits * level)) - 1)) != 0) {
+                    continue;
+                }
+                uint32_t id = Take(level * kSlots + ((current_ >> (SlotBits * level)) & kMask));
+                while (id != kNil) {
+                    const uint32_t next = entries_[id].next;
+                    count_[level]--;
+                    Link(id);
+                    id = next;
+                }
+            }
+
+            const uint32_t head = Take(current_ & kMask);
+            size_t published = 0;
+            for (uint32_t id = head; id != kNil; id = entries_[id].next) {
+                published++;
+            }
+            if (published == 0) {
+                return 0;
+            }
+
+            // 先写入所有到期的消息, 离开作用域时一次提交; 超过容量时分批, 申请失败的消息已经记录错误, 丢弃
+            const size_t limit = notebook_.GetHeader().item_num;
+            uint32_t id = head;
+            size_t written = 0;
+            for (size_t remain = published; remain > 0;) {
+                const size_t n = std::min(remain, limit);
+                BatchClaim<Book> batch(notebook_, n);
+                for (size_t k = 0; k < n; k++) {
+                    const uint32_t next = entries_[id].next;
+                    count_[0]--;
+                    if (batch.Size() == n) {
+                        CopyItem<sizeof(T)>(batch[k], &entries_[id].data);
+                    }
+                    Free(id);
+                    id = next;
+                }
+                written += batch.Size();
+                remain -= n;
+            }
+            return written;
+        }
+
+    public:
+        // tick_ns为tick长度, 到期时间按tick取整, now为tick 0的时间
+        TimerWheel(Book &notebook, const int64_t &tick_ns, const int64_t &now = NowNanos())
+            : notebook_(notebook), tick_ns_(tick_ns), start_(now) {
+            head_.fill(kNil);
+            tail_.fill(kNil);
+        }
+
+        // 登记在due_ns(纳秒)写入的消息, 返回用于取消的编号; 已经到期的消息在下一次Advance时写入
+        uint64_t Schedule(const T &data, const int64_t &due_ns) {
+            uint32_t id = free_;
+            if (id == kNil) {
+                id = entries_.size();
+                entries_.emplace_back();
+                entries_[id].generation = 0;
+            } else {
+                free_ = entries_[id].next;
+            }
+
+            auto &entry = entries_[id];
+            entry.data = data;
+            entry.due = std::max((due_ns - start_ + tick_ns_ - 1) / tick_ns_, current_);
+            entry.active = true;
+            Link(id);
+            size_++;
+            return (uint64_t(entry.generation) << 32) | id;
+        }
+
+        uint64_t ScheduleAfter(const T &data, const int64_t &delay_ns) {
+            return Schedule(data, NowNanos() + delay_ns);
+        }
+
+        // 取消尚未写入的消息, 已经写入或者已经取消时返回false
+        bool Cancel(const uint64_t &timer_id) {
+            const uint32_t id = timer_id & 0xffffffff;
+            if (id >= entries_.size() || !entries_[id].active || entries_[id].generation != timer_id >> 32) {
+                return false;
+            }
+            Unlink(id);
+            Free(id);
+            return true;
+        }
+
+        // 处理到now(纳秒)为止所有的tick, 返回写入的消息数量
+        size_t Advance(const int64_t &now = NowNanos()) {
+            const int64_t target = (now - start_) / tick_ns_;
+            size_t published = 0;
+            while (current_ <= target) {
+                if (size_ == 0) {
+                    current_ = target + 1;//没有等待中的消息, 直接跳过
+                    break;
+                }
+                published += Tick();
+                current_++;
+
+                // 低层没有消息时, 直到下一次重新分配之前的tick都不需要处理
+                size_t level = 0;
+                while (level + 1 < Levels && count_[level] == 0) {
+                    level++;
+                }
+                if (level > 0) {
+                    const int64_t span = int64_t(1) << (SlotBits * level);
+                    current_ = std::min((current_ + span - 1) & ~(span - 1), target + 1);
+                }
+            }
+            return published;
+        }
+
+        // 等待中的消息数量
+        size_t Size() const {
+            return size_;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_TIMER_H
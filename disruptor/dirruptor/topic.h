@@ -0,0 +1,272 @@
+#ifndef MULTI_SHM_QUEUE_TOPIC_H
+#define MULTI_SHM_QUEUE_TOPIC_H
+
+#include "spmc.h"
+#include <atomic>
+
+
+namespace disruptor {
+    static constexpr size_t kMaxTopics = 1024;  //一个目录最多多少个topic
+    static constexpr size_t kTopicAlign = 4096; //每个topic的数据区按系统页对齐
+
+    // topic登记, 状态为kTopicReady之后其余字段不再变化
+    struct TopicEntry {
+        static constexpr uint32_t kTopicEmpty = 0;
+        static constexpr uint32_t kTopicCreating = 1;
+        static constexpr uint32_t kTopicReady = 2;
+
+        std::atomic<uint32_t> state;//kTopicEmpty, kTopicCreating, kTopicReady
+        char name[60];              //topic名称
+        uint64_t item_size;         //结构体大小
+        uint64_t type_hash;         //结构体类型hash
+        uint64_t item_num;          //存入结构体数量
+        uint64_t offset;            //数据区在共享内存中的偏移
+        alignas(64) size_t cursor;  //浮标，已写入位置, 独占cache line
+    };
+
+    // 一个共享内存中的多个topic, 开头是目录, 之后是各个topic的数据区
+    struct Directory {
+        Header header;              //描述信息
+        std::atomic<size_t> used;   //已分配的字节数
+        std::atomic<pid_t> creator; //正在创建topic的进程, 0表示空闲; 创建串行执行, 同名topic只分配一次
+        TopicEntry topics[kMaxTopics];
+    };
+
+    // 一个topic, 与Notebook相同的一写多读接口
+    template<typename T>
+    class Topic {
+    private:
+        TopicEntry *entry_ = nullptr;
+        T *content_ = nullptr;
+
+    public:
+        Topic() = default;
+        Topic(TopicEntry *entry, char *base) {
+            entry_ = entry;
+            content_ = (T *) (base + entry->offset);
+        }
+
+        bool Valid() const { return entry_ != nullptr; }
+
+        size_t Capacity() const { return entry_->item_num; }
+
+        void SetData(const T &data) {
+            CopyItem<sizeof(T)>(&content_[entry_->cursor], &data);
+            Commit();
+        }
+
+        T *OpenData() {
+            return &content_[entry_->cursor];
+        }
+
+        void Commit() {
+            std::atomic_ref<size_t>(entry_->cursor).store(entry_->cursor + 1, std::memory_order_release);
+        };
+
+        size_t GetCursor() const {
+            return entry_->cursor;
+        }
+
+        //consumer
+        size_t WaitFor(const size_t &idx) {
+            int nCounter = 100;
+            while (true) {
+                const size_t current_cursor = std::atomic_ref<size_t>(entry_->cursor).load(std::memory_order_acquire);
+                if (idx < current_cursor) {
+                    return current_cursor;
+                }
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        T *GetData(const size_t &idx) {
+            return &content_[idx];
+        }
+    };
+
+    // topic目录, 所有topic共用一个共享内存文件和一次映射, 按名称创建和查找
+    class TopicDirectory {
+    private:
+        Directory *directory_ = nullptr;
+        size_t size_ = 0;
+
+        static Header MakeDirectoryHeader(const size_t &size) {
+            Header header{};
+            header.magic = kMagic;
+            header.version = kLayoutVersion;
+            header.layout = 3;
+            header.item_size = sizeof(TopicEntry);
+            header.type_hash = TypeHash<TopicEntry>();
+            header.item_num = kMaxTopics;
+            header.page_size = size;
+            header.page_num = 1;
+            header.mark_size = sizeof(Directory);
+            header.create_time = NowNanos();
+            return header;
+        }
+
+        TopicEntry *Find(const std::string &name) {
+            for (auto &entry: directory_->topics) {
+                if (entry.state.load(std::memory_order_acquire) == TopicEntry::kTopicReady &&
+                    strncmp(entry.name, name.c_str(), sizeof(entry.name)) == 0) {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        // 获取创建锁, 持有者已经退出时接管
+        void LockCreate() {
+            const pid_t self = getpid();
+            int nCounter = 100;
+            pid_t holder = 0;
+            while (!directory_->creator.compare_exchange_weak(holder, self)) {
+                if (holder != 0 && !ProcessAlive(holder)) {
+                    SPDLOG_WARN("Topic creator {} exited, take over.", holder);
+                    continue;//holder为退出的进程, 下一次CAS从它接管
+                }
+                holder = 0;
+                //spins --> yield
+                if (nCounter == 0) {
+                    std::this_thread::yield();
+                } else {
+                    nCounter--;
+                }
+            }
+        }
+
+        void UnlockCreate() {
+            directory_->creator.store(0, std::memory_order_release);
+        }
+
+        template<typename T>
+        Topic<T> Allocate(const std::string &name, const size_t &item_num) {
+            for (auto &entry: directory_->topics) {
+                uint32_t state = TopicEntry::kTopicEmpty;
+                if (!entry.state.compare_exchange_strong(state, TopicEntry::kTopicCreating)) {
+                    continue;
+                }
+                const size_t bytes = (sizeof(T) * item_num + kTopicAlign - 1) / kTopicAlign * kTopicAlign;
+                size_t offset = directory_->used.load();
+                do {
+                    if (offset + bytes > size_) {
+                        SPDLOG_ERROR("Topic directory is full, used:{}, need:{}, size:{}.", offset, bytes, size_);
+                        entry.state.store(TopicEntry::kTopicEmpty);
+                        return {};
+                    }
+                } while (!directory_->used.compare_exchange_weak(offset, offset + bytes));
+                strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
+                entry.item_size = sizeof(T);
+                entry.type_hash = TypeHash<T>();
+                entry.item_num = item_num;
+                entry.offset = offset;
+                entry.cursor = 0;
+                entry.state.store(TopicEntry::kTopicReady, std::memory_order_release);
+                SPDLOG_INFO("Create topic {}, item_num:{}, offset:{}.", name, item_num, offset);
+                return Topic<T>(&entry, (char *) directory_);
+            }
+            SPDLOG_ERROR("Too many topics, max:{}.", kMaxTopics);
+            return {};
+        }
+
+        template<typename T>
+        static bool Check(const TopicEntry *entry, const std::string &name) {
+            if (entry->item_size != sizeof(T) || entry->type_hash != TypeHash<T>()) {
+                SPDLOG_ERROR("Topic {} type mismatch, item_size:{}, expected:{}.", name, entry->item_size, sizeof(T));
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        TopicDirectory() = default;
+        ~TopicDirectory() = default;
+
+        // size为整个共享内存的大小, 包括目录和所有topic的数据区
+        bool Init(const std::string &folder_path, const size_t &size, const bool &writer, const bool &init) {
+            auto page = Page(folder_path + "_topics.store", writer, size);
+            if (!page.GetShm()) {
+                return false;
+            }
+            directory_ = (Directory *) page.GetShmDataAddress();
+            size_ = size;
+
+            const auto expected = MakeDirectoryHeader(size);
+            if (init) {
+                directory_->header = expected;
+                directory_->used.store((sizeof(Directory) + kTopicAlign - 1) / kTopicAlign * kTopicAlign);
+                directory_->creator.store(0);
+                for (auto &entry: directory_->topics) {
+                    entry.state.store(TopicEntry::kTopicEmpty);
+                    memset(entry.name, 0, sizeof(entry.name));
+                }
+            } else if (!CheckHeader(directory_->header, expected)) {
+                return false;
+            }
+            return true;
+        }
+
+        // 只根据路径加载, 共享内存大小从目录的描述信息读取
+        bool Attach(const std::string &folder_path, const bool &writer = false) {
+            auto header = (const Header *) Page::Map(folder_path + "_topics.store", sizeof(Header), false);
+            if (header == nullptr) {
+                return false;
+            }
+            const size_t size = header->page_size;
+            munmap((void *) header, sizeof(Header));
+            return Init(folder_path, size, writer, false);
+        }
+
+        // 创建topic, 已存在时校验类型后直接返回; 只有写入方可以创建
+        template<typename T>
+        Topic<T> Create(const std::string &name, const size_t &item_num) {
+            if (name.empty() || name.size() >= sizeof(TopicEntry::name)) {
+                SPDLOG_ERROR("Bad topic name: {}.", name);
+                return {};
+            }
+            if (auto entry = Find(name); entry != nullptr) {
+                return Check<T>(entry, name) ? Topic<T>(entry, (char *) directory_) : Topic<T>();
+            }
+
+            // 多个进程同时创建同名topic时, 拿到锁之后再查找一次, 只有第一个分配
+            LockCreate();
+            Topic<T> topic;
+            if (auto entry = Find(name); entry != nullptr) {
+                topic = Check<T>(entry, name) ? Topic<T>(entry, (char *) directory_) : Topic<T>();
+            } else {
+                topic = Allocate<T>(name, item_num);
+            }
+            UnlockCreate();
+            return topic;
+        }
+
+        // 按名称查找topic, 不存在或者类型不一致时返回无效的Topic
+        template<typename T>
+        Topic<T> Open(const std::string &name) {
+            auto entry = Find(name);
+            if (entry == nullptr) {
+                SPDLOG_ERROR("Topic {} not found.", name);
+                return {};
+            }
+            return Check<T>(entry, name) ? Topic<T>(entry, (char *) directory_) : Topic<T>();
+        }
+
+        // 所有已创建的topic名称
+        std::vector<std::string> List() const {
+            std::vector<std::string> names;
+            for (auto &entry: directory_->topics) {
+                if (entry.state.load(std::memory_order_acquire) == TopicEntry::kTopicReady) {
+                    names.emplace_back(entry.name, strnlen(entry.name, sizeof(entry.name)));
+                }
+            }
+            return names;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_TOPIC_H
@@ -0,0 +1,122 @@
+#ifndef MULTI_SHM_QUEUE_TOPOLOGY_H
+#define MULTI_SHM_QUEUE_TOPOLOGY_H
+
+#include "spdlog/spdlog.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace disruptor {
+    // 读取/sys下的单行文件, 失败时返回空字符串
+    inline std::string ReadSysFile(const std::string &path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    // 解析"0-3,8,10-11"格式的cpu列表
+    inline std::vector<int> ParseCpuList(const std::string &list) {
+        std::vector<int> cpus;
+        size_t begin = 0;
+        while (begin < list.size()) {
+            size_t end = list.find(',', begin);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            const std::string range = list.substr(begin, end - begin);
+            const size_t dash = range.find('-');
+            if (!range.empty()) {
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; cpu++) {
+                    cpus.push_back(cpu);
+                }
+            }
+            begin = end + 1;
+        }
+        return cpus;
+    }
+
+    inline std::string FormatCpuList(const std::vector<int> &cpus) {
+        std::string out;
+        for (auto cpu: cpus) {
+            out += (out.empty() ? "" : ",") + std::to_string(cpu);
+        }
+        return out;
+    }
+
+    struct CpuInfo {
+        int cpu;    //逻辑cpu编号
+        int core;   //物理核编号, 同一个package内唯一
+        int package;//物理cpu编号
+        int node;   //NUMA节点, 没有NUMA信息时为0
+    };
+
+    // cpu拓扑, 从/sys/devices/system读取
+    class Topology {
+    private:
+        std::vector<CpuInfo> cpus_;
+
+    public:
+        bool Load() {
+            cpus_.clear();
+            const std::string root = "/sys/devices/system/";
+            for (auto cpu: ParseCpuList(ReadSysFile(root + "cpu/online"))) {
+                const std::string path = root + "cpu/cpu" + std::to_string(cpu) + "/topology/";
+                CpuInfo info{cpu, cpu, 0, 0};
+                if (auto core = ReadSysFile(path + "core_id"); !core.empty()) {
+                    info.core = std::stoi(core);
+                }
+                if (auto package = ReadSysFile(path + "physical_package_id"); !package.empty()) {
+                    info.package = std::stoi(package);
+                }
+                cpus_.push_back(info);
+            }
+            for (auto node: ParseCpuList(ReadSysFile(root + "node/online"))) {
+                for (auto cpu: ParseCpuList(ReadSysFile(root + "node/node" + std::to_string(node) + "/cpulist"))) {
+                    if (auto info = Find(cpu); info != nullptr) {
+                        info->node = node;
+                    }
+                }
+            }
+            if (cpus_.empty()) {
+                SPDLOG_ERROR("Failed to read cpu topology.");
+                return false;
+            }
+            return true;
+        }
+
+        const std::vector<CpuInfo> &Cpus() const {
+            return cpus_;
+        }
+
+        CpuInfo *Find(const int &cpu) {
+            for (auto &info: cpus_) {
+                if (info.cpu == cpu) {
+                    return &info;
+                }
+            }
+            return nullptr;
+        }
+
+        // 两个cpu的关系: smt同一个物理核, core同一个物理cpu, package同一个NUMA节点, node跨NUMA节点
+        std::string Relation(const int &a, const int &b) {
+            auto x = Find(a);
+            auto y = Find(b);
+            if (x == nullptr || y == nullptr) {
+                return "unknown";
+            }
+            if (x->package == y->package && x->core == y->core) {
+                return "smt";
+            }
+            if (x->package == y->package) {
+                return "core";
+            }
+            return x->node == y->node ? "package" : "node";
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_TOPOLOGY_H
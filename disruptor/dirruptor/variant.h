@@ -0,0 +1,99 @@
+#ifndef MULTI_SHM_QUEUE_VARIANT_H
+#define MULTI_SHM_QUEUE_VARIANT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace disruptor {
+    // 多个lambda组成一个handler, 按参数类型重载
+    template<typename... Fs>
+    struct Overload : Fs... {
+        using Fs::operator()...;
+    };
+    template<typename... Fs>
+    Overload(Fs...) -> Overload<Fs...>;
+
+    // 一个Notebook中传递多种消息, Notebook<Variant<A, B, C>>
+    // slot大小为最大的消息加上一个类型字节, 消息直接在slot中构造, 不需要中间拷贝
+    // 消息在共享内存中传递, 必须是可以按字节拷贝的类型
+    template<typename... Ts>
+    class Variant {
+        static_assert(sizeof...(Ts) > 0 && sizeof...(Ts) < 256, "Variant requires 1 to 255 alternatives.");
+        static_assert((std::is_trivially_copyable_v<Ts> && ...), "Variant alternatives must be trivially copyable.");
+
+    public:
+        static constexpr size_t kSize = std::max({sizeof(Ts)...});
+        static constexpr size_t kAlign = std::max({alignof(Ts)...});
+        static constexpr uint8_t kEmpty = 0xff;
+
+        // 类型在Ts中的序号, 即类型字节的值
+        template<typename U>
+        static constexpr uint8_t IndexOf() {
+            static_assert((std::is_same_v<U, Ts> || ...), "Type is not an alternative of this Variant.");
+            uint8_t index = 0;
+            ((std::is_same_v<U, Ts> ? false : (index++, true)) && ...);
+            return index;
+        }
+
+    private:
+        alignas(kAlign) unsigned char storage_[kSize];
+        uint8_t tag_ = kEmpty;
+
+        // 编译期生成的分发表, 每种类型一项
+        template<typename Handler>
+        static constexpr void (*table_[])(const void *, Handler &) = {
+                [](const void *p, Handler &handler) { handler(*(const Ts *) p); }...};
+
+    public:
+        // 在slot中直接构造消息
+        template<typename U, typename... Args>
+        U *Emplace(Args &&...args) {
+            auto p = new (storage_) U{std::forward<Args>(args)...};
+            tag_ = IndexOf<U>();
+            return p;
+        }
+
+        template<typename U>
+        void Set(const U &value) {
+            Emplace<U>(value);
+        }
+
+        uint8_t Index() const {
+            return tag_;
+        }
+
+        template<typename U>
+        bool Is() const {
+            return tag_ == IndexOf<U>();
+        }
+
+        // 类型不一致时返回nullptr
+        template<typename U>
+        const U *Get() const {
+            return Is<U>() ? std::launder((const U *) storage_) : nullptr;
+        }
+
+        template<typename U>
+        U *Get() {
+            return Is<U>() ? std::launder((U *) storage_) : nullptr;
+        }
+
+        // 按类型调用handler, 查表跳转, 不需要switch; 类型字节无效时返回false
+        template<typename Handler>
+        bool Dispatch(Handler &&handler) const {
+            using H = std::remove_reference_t<Handler>;
+            if (tag_ >= sizeof...(Ts)) {
+                return false;
+            }
+            table_<H>[tag_](storage_, handler);
+            return true;
+        }
+    };
+}// namespace disruptor
+
+#endif//MULTI_SHM_QUEUE_VARIANT_H
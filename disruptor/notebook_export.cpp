@@ -0,0 +1,65 @@
+#include "logger.h"
+#include "dirruptor/export.h"
+#include <iostream>
+
+// 把Notebook的page文件导出为列文件, 每个字段一个文件
+// usage: notebook_export <folder_path> <out_path> <name:offset:type[:delta]>... [-t threads] [-b block_size]
+// type: i8 i16 i32 i64 u8 u16 u32 u64 f32 f64
+
+static bool ParseType(const std::string &name, disruptor::ColumnType &type) {
+    static const std::vector<std::string> names = {"i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64"};
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            type = (disruptor::ColumnType) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        std::cout << "usage: notebook_export <folder_path> <out_path> <name:offset:type[:delta]>... [-t threads] [-b block_size]" << std::endl;
+        return 1;
+    }
+    if (!ots::utils::create_logger("notebook_export.log", "info", false, false, false)) {
+        return 1;
+    }
+    const std::string folder_path = argv[1];
+    const std::string out_path = argv[2];
+
+    disruptor::ColumnExporter exporter;
+    for (int i = 3; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((arg == "-t" || arg == "-b") && i + 1 < argc) {
+            const size_t value = std::stoul(argv[++i]);
+            arg == "-t" ? exporter.SetThreadNum(value) : exporter.SetBlockSize(value);
+            continue;
+        }
+
+        std::vector<std::string> parts;
+        for (size_t begin = 0, end; begin <= arg.size(); begin = end + 1) {
+            end = std::min(arg.find(':', begin), arg.size());
+            parts.push_back(arg.substr(begin, end - begin));
+        }
+        disruptor::ColumnType type;
+        if (parts.size() < 3 || !ParseType(parts[2], type) || (parts.size() > 3 && parts[3] != "delta")) {
+            SPDLOG_ERROR("Bad column: {}.", arg);
+            return 1;
+        }
+        if (!exporter.AddColumn(parts[0], std::stoul(parts[1]), type, parts.size() > 3)) {
+            return 1;
+        }
+    }
+
+    disruptor::Journal journal;
+    if (!journal.Open(folder_path)) {
+        return 1;
+    }
+    const int64_t begin = disruptor::NowNanos();
+    if (!exporter.Export(journal, out_path)) {
+        return 1;
+    }
+    SPDLOG_INFO("Export {} done, {:.3f} s.", folder_path, (disruptor::NowNanos() - begin) / 1e9);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "logger.h"
+#include "dirruptor/placement.h"
+#include "dirruptor/replay.h"
+#include "dirruptor/spmc.h"
+#include "dirruptor/topology.h"
+#include <iostream>
+#include <map>
+#include <thread>
+
+// 在每一对cpu之间通过两个Notebook来回传递消息, 测量cache到cache的延迟, 输出延迟矩阵和推荐的生产者/消费者位置
+// usage: notebook_pingpong [cpu_list] [rounds]
+
+typedef struct {
+    size_t seq;
+    char data[56];
+} PingData;
+
+int main(int argc, char **argv) {
+    if (!ots::utils::create_logger("notebook_pingpong.log", "info", false, false, false)) {
+        return 1;
+    }
+    disruptor::Topology topology;
+    if (!topology.Load()) {
+        return 1;
+    }
+    std::vector<int> cpus;
+    if (argc > 1) {
+        cpus = disruptor::ParseCpuList(argv[1]);
+    } else {
+        for (auto &info: topology.Cpus()) {
+            cpus.push_back(info.cpu);
+        }
+    }
+    const size_t rounds = argc > 2 ? std::stoul(argv[2]) : 1000;
+    const size_t warmup = rounds / 10;
+    if (cpus.size() < 2) {
+        std::cout << "usage: notebook_pingpong [cpu_list] [rounds], at least two cpus are required" << std::endl;
+        return 1;
+    }
+
+    // 每一对cpu使用Notebook中不同的区间, 不需要重新初始化
+    const size_t pair_num = cpus.size() * (cpus.size() - 1);
+    auto ping = disruptor::Notebook<PingData>();
+    auto pong = disruptor::Notebook<PingData>();
+    if (!ping.Init("pingpong_ping", pair_num * (rounds + warmup), true, true) ||
+        !pong.Init("pingpong_pong", pair_num * (rounds + warmup), true, true)) {
+        return 1;
+    }
+    disruptor::TscClock clock;
+    clock.Calibrate();
+
+    // latency[i][j]: cpu i写入, cpu j读取的单程延迟中位数, 纳秒
+    std::vector<std::vector<double>> latency(cpus.size(), std::vector<double>(cpus.size(), 0));
+    size_t base = 0;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        for (size_t j = 0; j < cpus.size(); j++) {
+            if (i == j) {
+                continue;
+            }
+            std::thread responder([&, j, base]() {
+                if (!disruptor::PinThread({cpus[j]})) {
+                    SPDLOG_WARN("Failed to pin cpu {}.", cpus[j]);
+                }
+                for (size_t k = base; k < base + rounds + warmup; k++) {
+                    ping.WaitFor(k);
+                    pong.SetData(*ping.GetData(k));
+                }
+            });
+
+            if (!disruptor::PinThread({cpus[i]})) {
+                SPDLOG_WARN("Failed to pin cpu {}.", cpus[i]);
+            }
+            std::vector<uint64_t> samples;
+            samples.reserve(rounds);
+            for (size_t k = base; k < base + rounds + warmup; k++) {
+                PingData data{};
+                data.seq = k;
+                const uint64_t begin = disruptor::TscClock::Ticks();
+                ping.SetData(data);
+                pong.WaitFor(k);
+                const uint64_t end = disruptor::TscClock::Ticks();
+                if (k >= base + warmup) {
+                    samples.push_back(end - begin);
+                }
+            }
+            responder.join();
+            base += rounds + warmup;
+
+            std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+            latency[i][j] = clock.ToNanos(samples[samples.size() / 2]) / 2;
+        }
+    }
+
+    std::string out = fmt::format("one-way latency (ns), row: producer, column: consumer\n{:>6}", "");
+    for (auto cpu: cpus) {
+        out += fmt::format("{:>8}", cpu);
+    }
+    out += "\n";
+    for (size_t i = 0; i < cpus.size(); i++) {
+        out += fmt::format("{:>6}", cpus[i]);
+        for (size_t j = 0; j < cpus.size(); j++) {
+            out += i == j ? fmt::format("{:>8}", "-") : fmt::format("{:>8.0f}", latency[i][j]);
+        }
+        out += "\n";
+    }
+
+    // 按关系汇总, 推荐不在同一个物理核上的最快的一对; 同一个物理核的两个超线程会互相抢占执行资源
+    std::map<std::string, std::pair<double, size_t>> relations;
+    size_t best_i = 0, best_j = 1;
+    double best = -1;
+    bool best_smt = true;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        for (size_t j = 0; j < cpus.size(); j++) {
+            if (i == j) {
+                continue;
+            }
+            const auto relation = topology.Relation(cpus[i], cpus[j]);
+            relations[relation].first += latency[i][j];
+            relations[relation].second++;
+            // 只有同一个物理核上的cpu时才推荐超线程
+            const bool smt = relation == "smt";
+            if (best < 0 || (smt == best_smt && latency[i][j] < best) || (!smt && best_smt)) {
+                best = latency[i][j];
+                best_smt = smt;
+                best_i = i;
+                best_j = j;
+            }
+        }
+    }
+    for (auto &[relation, sum]: relations) {
+        out += fmt::format("{:<8} mean {:.0f} ns over {} pairs\n", relation, sum.first / sum.second, sum.second);
+    }
+    if (best >= 0) {
+        out += fmt::format("recommended: producer cpu {}, consumer cpu {}, {:.0f} ns, {}\n",
+                           cpus[best_i], cpus[best_j], best, topology.Relation(cpus[best_i], cpus[best_j]));
+    }
+    std::cout << out;
+
+    disruptor::Page("pingpong_ping_page_0.store", false).RemoveShm();
+    disruptor::Page("pingpong_pong_page_0.store", false).RemoveShm();
+    return 0;
+}
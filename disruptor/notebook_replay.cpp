@@ -0,0 +1,42 @@
+#include "logger.h"
+#include "dirruptor/replay.h"
+#include <iostream>
+
+// 按原始时间间隔把记录的Notebook回放到一个新的Notebook, 新Notebook的布局和结构体类型与原来一致
+// usage: notebook_replay <folder_path> <out_path> <timestamp_offset> [speed] [begin] [end]
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        std::cout << "usage: notebook_replay <folder_path> <out_path> <timestamp_offset> [speed] [begin] [end]" << std::endl;
+        return 1;
+    }
+    if (!ots::utils::create_logger("notebook_replay.log", "info", false, false, false)) {
+        return 1;
+    }
+    const std::string folder_path = argv[1];
+    const std::string out_path = argv[2];
+    const size_t timestamp_offset = std::stoul(argv[3]);
+    const double speed = argc > 4 ? std::stod(argv[4]) : 1.0;
+
+    disruptor::Journal source;
+    if (!source.Open(folder_path)) {
+        return 1;
+    }
+    const size_t begin = argc > 5 ? std::stoul(argv[5]) : 0;
+    const size_t end = argc > 6 ? std::min<size_t>(std::stoul(argv[6]), source.GetCursor()) : source.GetCursor();
+
+    disruptor::Journal target;
+    if (!disruptor::Journal::Create(out_path, source.GetHeader()) || !target.Open(out_path, true)) {
+        return 1;
+    }
+
+    disruptor::Replayer replayer;
+    replayer.SetSpeed(speed);
+    SPDLOG_INFO("Replay {} -> {}, [{}, {}), speed:{}.", folder_path, out_path, begin, end, speed);
+    const auto report = replayer.Replay(source, timestamp_offset, begin, end, [&target](const char *item) {
+        target.Append(item);
+    });
+    SPDLOG_INFO("Replay done, count:{}, elapsed:{:.3f} s, drift(ns) mean:{:.0f}, p50:{}, p99:{}, p999:{}, max:{}.",
+                report.count, report.elapsed, report.mean, report.p50, report.p99, report.p999, report.max);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "logger.h"
+#include "dirruptor/spmc.h"
+#include <iostream>
+#include <thread>
+
+// 只读加载书签, 显示生产者和消费者的位置、落后程度和等待次数
+// usage: notebook_top <folder_path> [interval_ms] [count]
+
+// 估算消费者落后的时间: 生产者第一次越过position的采样时间, 返回是否超出采样窗口
+static bool LagNanos(const disruptor::Bookmark *bookmark, const size_t &position, const int64_t &now, int64_t &lag) {
+    lag = 0;
+    const size_t sample_num = bookmark->sample_num.load(std::memory_order_acquire);
+    if (sample_num == 0 || position >= bookmark->cursor) {
+        return false;
+    }
+    const size_t first = sample_num > disruptor::kMaxSamples ? sample_num - disruptor::kMaxSamples : 0;
+    for (size_t i = first; i < sample_num; i++) {
+        auto &sample = bookmark->samples[i % disruptor::kMaxSamples];
+        if (sample.cursor.load(std::memory_order_relaxed) > position) {
+            lag = now - sample.time.load(std::memory_order_relaxed);
+            return i == first;
+        }
+    }
+    lag = now - bookmark->samples[(sample_num - 1) % disruptor::kMaxSamples].time.load(std::memory_order_relaxed);
+    return false;
+}
+
+static std::string State(const pid_t &pid) {
+    if (pid == 0) {
+        return "exited";
+    }
+    return disruptor::ProcessAlive(pid) ? "alive" : "dead";
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage: notebook_top <folder_path> [interval_ms] [count]" << std::endl;
+        return 1;
+    }
+    if (!ots::utils::create_logger("notebook_top.log", "info", false, false, false)) {
+        return 1;
+    }
+    const std::string folder_path = argv[1];
+    const int interval_ms = argc > 2 ? std::stoi(argv[2]) : 1000;
+    const int count = argc > 3 ? std::stoi(argv[3]) : 0;
+
+    auto bookmark = (const disruptor::Bookmark *) disruptor::Page::Map(folder_path + "_page_0.store", sizeof(disruptor::Bookmark), false);
+    if (bookmark == nullptr) {
+        return 1;
+    }
+    const auto &header = bookmark->header;
+    if (header.magic != disruptor::kMagic || header.version != disruptor::kLayoutVersion || header.mark_size != sizeof(disruptor::Bookmark)) {
+        SPDLOG_ERROR("Not a notebook or layout mismatch: {}.", folder_path);
+        return 1;
+    }
+
+    size_t last_cursor = bookmark->cursor;
+    std::vector<size_t> last_position(disruptor::kMaxConsumers);
+    for (size_t i = 0; i < disruptor::kMaxConsumers; i++) {
+        last_position[i] = bookmark->consumers[i].position.load(std::memory_order_relaxed);
+    }
+
+    for (int round = 0; count == 0 || round < count; round++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        const int64_t now = disruptor::NowNanos();
+        const double seconds = interval_ms / 1000.0;
+        const size_t cursor = bookmark->cursor;
+        const auto &producer = bookmark->producer;
+
+        std::string out = "\033[2J\033[H";
+        out += fmt::format("notebook: {}, item_num: {}, item_size: {}, page_num: {}\n",
+                           folder_path, header.item_num, header.item_size, header.page_num);
+        out += fmt::format("producer: pid {} {}, cursor {}, {:.0f} msg/s, heartbeat {:.1f} ms ago\n\n",
+                           producer.pid.load(), State(producer.pid.load()), cursor,
+                           cursor > last_cursor ? (cursor - last_cursor) / seconds : 0.0,
+                           producer.time.load() == 0 ? 0.0 : (now - producer.time.load()) / 1e6);
+        out += fmt::format("{:<28}{:>8}{:>8}{:>14}{:>14}{:>12}{:>12}{:>12}{:>10}{:>14}\n",
+                           "consumer", "pid", "state", "position", "committed", "lag(msg)", "lag(ms)", "msg/s", "stalls", "heartbeat(ms)");
+        for (size_t i = 0; i < disruptor::kMaxConsumers; i++) {
+            auto &consumer = bookmark->consumers[i];
+            if (consumer.name[0] == 0) {
+                continue;
+            }
+            const size_t position = consumer.position.load(std::memory_order_relaxed);
+            int64_t lag = 0;
+            const bool overflow = LagNanos(bookmark, position, now, lag);
+            out += fmt::format("{:<28}{:>8}{:>8}{:>14}{:>14}{:>12}{:>12}{:>12.0f}{:>10}{:>14.1f}\n",
+                               std::string(consumer.name, strnlen(consumer.name, sizeof(consumer.name))),
+                               consumer.pid.load(), State(consumer.pid.load()), position,
+                               consumer.committed.load(std::memory_order_relaxed),
+                               cursor > position ? cursor - position : 0,
+                               (overflow ? ">" : "") + fmt::format("{:.1f}", lag / 1e6),
+                               position > last_position[i] ? (position - last_position[i]) / seconds : 0.0,
+                               consumer.stalls.load(std::memory_order_relaxed),
+                               (now - consumer.time.load()) / 1e6);
+            last_position[i] = position;
+        }
+        last_cursor = cursor;
+        std::cout << out << std::flush;
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "logger.h"
+#include "dirruptor/checksum.h"
+#include "dirruptor/journal.h"
+#include <iostream>
+
+// 离线校验ChecksumNotebook的page文件, 逐个位置计算CRC32C并与folder_path_crc.store比较
+// usage: notebook_verify <folder_path> [max_report]
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage: notebook_verify <folder_path> [max_report]" << std::endl;
+        return 1;
+    }
+    if (!ots::utils::create_logger("notebook_verify.log", "info", false, false, false)) {
+        return 1;
+    }
+    const std::string folder_path = argv[1];
+    const size_t max_report = argc > 2 ? std::stoul(argv[2]) : 16;
+
+    disruptor::Journal journal;
+    if (!journal.Open(folder_path)) {
+        return 1;
+    }
+    const size_t cursor = journal.GetCursor();
+    const size_t size = disruptor::ChecksumFileSize(journal.GetHeader().item_num);
+    auto checksums = (const uint32_t *) disruptor::Page::Map(folder_path + "_crc.store", size, false);
+    if (checksums == nullptr) {
+        return 1;
+    }
+
+    const int64_t begin = disruptor::NowNanos();
+    size_t bad = 0;
+    for (size_t idx = 0; idx < cursor; idx++) {
+        const uint32_t crc = disruptor::Crc32c(journal.Item(idx), journal.ItemSize());
+        if (crc != checksums[idx]) {
+            if (bad < max_report) {
+                SPDLOG_ERROR("Checksum mismatch at {}, stored:{:#010x}, actual:{:#010x}.", idx, checksums[idx], crc);
+            }
+            bad++;
+        }
+    }
+    const int64_t elapsed = disruptor::NowNanos() - begin;
+    SPDLOG_INFO("Verify {}, items:{}, bad:{}, {:.1f} ns/item.", folder_path, cursor, bad, cursor == 0 ? 0.0 : (double) elapsed / cursor);
+    return bad == 0 ? 0 : 2;
+}
@@ -0,0 +1,60 @@
+#include "logger.h"
+#include "dirruptor/arena.h"
+#include <iostream>
+#include <thread>
+
+// 通过Notebook传递的描述, 数据在arena中
+typedef struct {
+    disruptor::Blob blob;
+    size_t th;
+} TestBlobData;
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "info", false, false, false);
+    const size_t item_num = 1024 * 64;
+
+    auto notebook = disruptor::Notebook<TestBlobData>();
+    notebook.Init("test_blob", item_num, true, true);
+    auto arena = disruptor::Arena();
+    arena.Init("test", 4 * disruptor::Page::MB, true, true);
+
+    // reader, 登记之后生产者按它的位置回收
+    std::thread reader([item_num]() {
+        auto notebook = disruptor::Notebook<TestBlobData>();
+        notebook.Attach("test_blob");
+        notebook.RegisterConsumer("test_arena");
+        auto arena = disruptor::Arena();
+        arena.Init("test", 4 * disruptor::Page::MB, false, false);
+        size_t idx = 0;
+        size_t error = 0;
+        while (idx < item_num) {
+            idx = notebook.ForEach(idx, std::min(notebook.WaitFor(idx), item_num), [&](const size_t &, TestBlobData *ret) {
+                auto data = (const size_t *) arena.Get(ret->blob);
+                for (size_t j = 0; j < ret->blob.length / sizeof(size_t); j++) {
+                    if (data[j] != ret->th) {
+                        error++;
+                    }
+                }
+            });
+        }
+        SPDLOG_INFO("reader end, error:{}.", error);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    SPDLOG_INFO("start.");
+    for (size_t i = 0; i < item_num; i++) {
+        const size_t length = sizeof(size_t) * (1 + i % 1024);
+        TestBlobData item{};
+        auto data = (size_t *) arena.Allocate(length, item.blob, notebook);
+        for (size_t j = 0; j < length / sizeof(size_t); j++) {
+            data[j] = i;
+        }
+        item.th = i;
+        arena.Commit(item.blob, notebook.GetCursor());
+        notebook.SetData(item);
+    }
+    SPDLOG_INFO("end, used:{}.", arena.Used());
+    reader.join();
+    return 0;
+}
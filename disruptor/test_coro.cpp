@@ -0,0 +1,97 @@
+#include "logger.h"
+#include "dirruptor/coro.h"
+#include <iostream>
+#include <thread>
+
+typedef struct {
+    size_t th;
+    char data[128];
+} TestCoroData;
+
+
+// 逐条读取
+disruptor::Task ReadItems(disruptor::Subscription<disruptor::Notebook<TestCoroData>> &subscription, const size_t item_num) {
+    size_t error = 0;
+    for (size_t i = 0; i < item_num; i++) {
+        auto data = co_await subscription.Next();
+        if (data->th != i) {
+            error++;
+        }
+    }
+    SPDLOG_INFO("items end, error:{}.", error);
+}
+
+// 批量读取
+disruptor::Task ReadBatches(disruptor::Notebook<TestCoroData> &notebook, disruptor::Subscription<disruptor::Notebook<TestCoroData>> &subscription, const size_t item_num) {
+    size_t error = 0;
+    size_t batch_num = 0;
+    while (subscription.Position() < item_num) {
+        auto batch = co_await subscription.NextBatch(item_num - subscription.Position());
+        notebook.ForEach(batch.begin, batch.end, [&](const size_t &idx, TestCoroData *data) {
+            if (data->th != idx) {
+                error++;
+            }
+        });
+        batch_num++;
+    }
+    SPDLOG_INFO("batches end, batch_num:{}, error:{}.", batch_num, error);
+}
+
+// 记录每次读取的订阅编号, 用于检查执行器上的订阅是否交替执行
+disruptor::Task ReadOrder(disruptor::Subscription<disruptor::Notebook<TestCoroData>> &subscription, const size_t item_num,
+                          const int id, std::vector<int> &order) {
+    for (size_t i = 0; i < item_num; i++) {
+        co_await subscription.Next();
+        order.push_back(id);
+    }
+}
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "info", false, false, false);
+    const size_t item_num = 1024 * 1024;
+
+    auto writer = disruptor::Notebook<TestCoroData>();
+    writer.Init("test", item_num, true, true);
+
+    // 两个订阅共用一个线程
+    std::thread reader([item_num]() {
+        auto notebook = disruptor::Notebook<TestCoroData>();
+        notebook.Attach("test");
+        disruptor::Executor executor;
+        disruptor::Subscription items(notebook, executor);
+        disruptor::Subscription batches(notebook, executor);
+        executor.Spawn(ReadItems(items, item_num));
+        executor.Spawn(ReadBatches(notebook, batches, item_num));
+        executor.Run();
+    });
+
+    SPDLOG_INFO("start.");
+    for (size_t i = 0; i < item_num; i++) {
+        TestCoroData data{};
+        data.th = i;
+        writer.SetData(data);
+    }
+    SPDLOG_INFO("end.");
+    reader.join();
+
+    // 数据都已写入时, 两个订阅仍然交替执行, 每次最多连续读取yield_interval + 1条
+    {
+        auto notebook = disruptor::Notebook<TestCoroData>();
+        notebook.Attach("test");
+        disruptor::Executor executor;
+        disruptor::Subscription first(notebook, executor);
+        disruptor::Subscription second(notebook, executor);
+        std::vector<int> order;
+        executor.Spawn(ReadOrder(first, 4096, 0, order));
+        executor.Spawn(ReadOrder(second, 4096, 1, order));
+        executor.Run();
+        size_t longest = 0;
+        for (size_t i = 0, run = 0; i < order.size(); i++) {
+            run = i > 0 && order[i] == order[i - 1] ? run + 1 : 1;
+            longest = std::max(longest, run);
+        }
+        SPDLOG_INFO("fairness, reads:{}, longest run:{}.", order.size(), longest);
+    }
+    return 0;
+}
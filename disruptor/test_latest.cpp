@@ -0,0 +1,45 @@
+#include "logger.h"
+#include "dirruptor/latest.h"
+#include <iostream>
+#include <thread>
+
+typedef struct {
+    size_t th;
+    char data[128];
+    size_t check;
+} TestLatestData;
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "trace", false, false, false);
+
+    auto writer = disruptor::LatestValue<TestLatestData>();
+    writer.Init("test", true, true);
+
+    // reader
+    std::thread reader([]() {
+        auto latest = disruptor::LatestValue<TestLatestData>();
+        latest.Init("test", false, false);
+        size_t last = 0;
+        size_t torn = 0;
+        while (last < 1024 * 1024) {
+            TestLatestData data{};
+            last = latest.Load(data);
+            if (data.th != data.check) {
+                torn++;
+            }
+        }
+        SPDLOG_INFO("reader end, version:{}, torn:{}.", last, torn);
+    });
+
+    SPDLOG_INFO("start.");
+    for (size_t i = 1; i <= 1024 * 1024; i++) {
+        TestLatestData data{};
+        data.th = i;
+        data.check = i;
+        writer.Store(data);
+    }
+    SPDLOG_INFO("end, version:{}.", writer.Version());
+    reader.join();
+    return 0;
+}
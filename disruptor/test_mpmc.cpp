@@ -1,6 +1,10 @@
 #include "logger.h"
+#include "dirruptor/claim.h"
 #include "dirruptor/mpmc.h"
 #include <iostream>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
 
 typedef struct {
     char data[128];
@@ -46,5 +50,142 @@ int main() {
         }
         SPDLOG_INFO("end.");
     }
+
+    // 新建的Notebook中cursor为-1, WaitFor(0)要等到第一次提交
+    {
+        auto notebook = atomic_disruptor::Notebook<TestBufferData>();
+        notebook.Init("atomic_wait", 1024, true, true);
+        std::atomic<bool> returned{false};
+        std::thread reader([&notebook, &returned]() {
+            notebook.WaitFor(0);
+            returned.store(true);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const bool early = returned.load();
+        auto idx = notebook.ClaimIndex();
+        notebook.Commit(idx);
+        reader.join();
+        SPDLOG_INFO("wait for 0, returned before commit:{}, after commit:{}.", early, returned.load());
+    }
+
+    // producer exits between ClaimIndex and Commit
+    {
+        auto notebook = atomic_disruptor::Notebook<TestBufferData>();
+        notebook.Init("atomic_recover", 1024, true, true);
+        pid_t pid = fork();
+        if (pid == 0) {
+            auto child = atomic_disruptor::Notebook<TestBufferData>();
+            child.Init("atomic_recover", 1024, true, false);
+            child.ClaimIndex();
+            _exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+
+        // 子进程占用的位置0被跳过, 位置1可以正常提交
+        auto idx = notebook.ClaimIndex();
+        notebook.OpenData(idx)->th = idx;
+        notebook.Commit(idx);
+        for (auto i = 0; i < 2; i++) {
+            notebook.WaitFor(i);
+            SPDLOG_INFO("idx:{}, skipped:{}.", i, notebook.IsSkipped(i));
+        }
+    }
+    // 多个线程共用一个写入对象, 各自登记; 线程0占用位置时暂停, 其他线程等待时不能跳过它的位置
+    {
+        auto notebook = atomic_disruptor::Notebook<TestBufferData>();
+        notebook.Init("atomic_shared", 1024 * 64, true, true);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; t++) {
+            threads.emplace_back([&notebook, t]() {
+                for (size_t i = 0; i < 4096; i++) {
+                    auto idx = notebook.ClaimIndex();
+                    notebook.OpenData(idx)->th = t;
+                    if (t == 0 && i % 1024 == 0) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    }
+                    notebook.Commit(idx);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        size_t skipped = 0;
+        for (size_t i = 0; i < notebook.GetCursor(); i++) {
+            skipped += notebook.IsSkipped(i);
+        }
+        SPDLOG_INFO("shared writer, cursor:{}, skipped:{}.", notebook.GetCursor(), skipped);
+    }
+
+    // 登记表已满时申请失败, 不和其他线程共用登记
+    {
+        auto notebook = atomic_disruptor::Notebook<TestBufferData>();
+        notebook.Init("atomic_full", 1024, true, true);
+        const size_t thread_num = atomic_disruptor::kMaxProducers + 6;
+        std::atomic<size_t> ready{0};
+        std::atomic<size_t> failed{0};
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_num; t++) {
+            threads.emplace_back([&notebook, &ready, &failed, thread_num]() {
+                auto claim = disruptor::Claim(notebook);
+                if (!claim.Valid()) {
+                    failed++;
+                }
+                // 所有线程同时存活, 登记不会被复用
+                ready++;
+                while (ready.load() < thread_num) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        SPDLOG_INFO("full producers, cursor:{}, failed:{}.", notebook.GetCursor(), failed.load());
+    }
+
+    // claim guard, 多个线程交替单条和批量申请
+    {
+        auto notebook = atomic_disruptor::Notebook<TestBufferData>();
+        notebook.Init("atomic_claim", 1024 * 64, true, true);
+        std::vector<std::thread> threads;
+        for (auto t = 0; t < 4; t++) {
+            threads.emplace_back([t]() {
+                auto writer = atomic_disruptor::Notebook<TestBufferData>();
+                writer.Init("atomic_claim", 1024 * 64, true, false);
+                for (auto i = 0; i < 1024; i++) {
+                    if (i % 2 == 0) {
+                        auto claim = disruptor::Claim(writer);
+                        claim->th = t;
+                    } else {
+                        disruptor::BatchClaim batch(writer, 8);
+                        for (size_t k = 0; k < batch.Size(); k++) {
+                            batch[k]->th = t;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        size_t count[4]{};
+        for (size_t i = 0; i < notebook.GetCursor(); i++) {
+            count[notebook.GetData(i)->th]++;
+        }
+        SPDLOG_INFO("claim, cursor:{}, per thread:{} {} {} {}.", notebook.GetCursor(), count[0], count[1], count[2], count[3]);
+
+        // 申请0个或者超过容量的位置时失败, next不变, 之后的申请从cursor开始
+        const size_t cursor = notebook.GetCursor();
+        const bool zero = notebook.ClaimIndex(0) == notebook.kNoIndex;
+        const bool oversized = notebook.ClaimIndex(1024 * 64 + 1) == notebook.kNoIndex;
+        {
+            disruptor::BatchClaim empty(notebook, 0);
+            disruptor::BatchClaim batch(notebook, 1024 * 64 + 1);
+            SPDLOG_INFO("claim, empty size:{}, oversized size:{}.", empty.Size(), batch.Size());
+        }
+        auto claim = disruptor::Claim(notebook);
+        SPDLOG_INFO("claim, zero:{}, oversized:{}, cursor:{}, next claim:{}.", zero, oversized, cursor, claim.Index());
+    }
     return 0;
 }
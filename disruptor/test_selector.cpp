@@ -0,0 +1,63 @@
+#include "logger.h"
+#include "dirruptor/mpmc.h"
+#include "dirruptor/selector.h"
+#include <iostream>
+#include <thread>
+
+typedef struct {
+    size_t th;
+    char data[120];
+} TestSelectData;
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "info", false, false, false);
+    const size_t item_num = 1024 * 1024;
+
+    auto spmc = disruptor::Notebook<TestSelectData>();
+    spmc.Init("test_select", item_num, true, true);
+    auto mpmc = atomic_disruptor::Notebook<TestSelectData>();
+    mpmc.Init("atomic_select", item_num, true, true);
+
+    // 一个消费线程读取两个Notebook, spmc的配额是mpmc的两倍
+    std::thread reader([&spmc, &mpmc, item_num]() {
+        disruptor::Selector selector;
+        const size_t a = selector.Add(spmc, 2);
+        const size_t b = selector.Add(mpmc, 1);
+        size_t error = 0;
+        while (selector.Position(a) < item_num || selector.Position(b) < item_num) {
+            selector.Select([&](const size_t &source, const size_t &begin, const size_t &end) {
+                for (auto idx = begin; idx < end; idx++) {
+                    auto data = source == a ? spmc.GetData(idx) : mpmc.GetData(idx);
+                    if (data->th != idx) {
+                        error++;
+                    }
+                }
+            });
+        }
+        for (auto source: {a, b}) {
+            auto &stats = selector.GetStats(source);
+            SPDLOG_INFO("source:{}, polls:{}, idle_polls:{}, batches:{}, items:{}.",
+                        source, stats.polls, stats.idle_polls, stats.batches, stats.items);
+        }
+        SPDLOG_INFO("reader end, error:{}.", error);
+    });
+
+    SPDLOG_INFO("start.");
+    std::thread writer([&mpmc, item_num]() {
+        for (size_t i = 0; i < item_num; i++) {
+            auto idx = mpmc.ClaimIndex();
+            mpmc.OpenData(idx)->th = idx;
+            mpmc.Commit(idx);
+        }
+    });
+    for (size_t i = 0; i < item_num; i++) {
+        TestSelectData data{};
+        data.th = i;
+        spmc.SetData(data);
+    }
+    writer.join();
+    SPDLOG_INFO("end.");
+    reader.join();
+    return 0;
+}
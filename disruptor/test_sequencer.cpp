@@ -0,0 +1,80 @@
+#include "logger.h"
+#include "dirruptor/sequencer.h"
+#include <iostream>
+#include <thread>
+
+typedef struct {
+    size_t gateway;
+    size_t th;
+    char data[112];
+} TestGatewayData;
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "info", false, false, false);
+    const size_t item_num = 1024 * 1024;
+
+    auto gateway_a = disruptor::Notebook<TestGatewayData>();
+    gateway_a.Init("test_gateway_a", item_num, true, true);
+    auto gateway_b = disruptor::Notebook<TestGatewayData>();
+    gateway_b.Init("test_gateway_b", item_num, true, true);
+    auto output = disruptor::Notebook<disruptor::Sequenced>();
+    output.Init("test_sequenced", 2 * item_num, true, true);
+
+    // 定序
+    std::atomic<bool> stop{false};
+    std::thread sequencer_thread([&]() {
+        disruptor::Sequencer<disruptor::Notebook<TestGatewayData>> sequencer(output);
+        sequencer.Add(gateway_a);
+        sequencer.Add(gateway_b);
+        sequencer.Run(stop);
+    });
+
+    // 下游按全局顺序读取
+    std::thread reader([&]() {
+        disruptor::Sequencer<disruptor::Notebook<TestGatewayData>> resolver(output);
+        resolver.Add(gateway_a);
+        resolver.Add(gateway_b);
+        size_t next[2] = {0, 0};
+        size_t error = 0;
+        for (size_t seq = 0; seq < 2 * item_num; seq++) {
+            output.WaitFor(seq);
+            auto descriptor = output.GetData(seq);
+            auto data = resolver.GetData(*descriptor);
+            if (descriptor->global_seq != seq || descriptor->index != next[descriptor->source]++ ||
+                data->gateway != descriptor->source || data->th != descriptor->index) {
+                error++;
+            }
+        }
+        SPDLOG_INFO("reader end, error:{}.", error);
+    });
+
+    SPDLOG_INFO("start.");
+    std::thread writer([&]() {
+        for (size_t i = 0; i < item_num; i++) {
+            TestGatewayData data{};
+            data.gateway = 1;
+            data.th = i;
+            gateway_b.SetData(data);
+        }
+    });
+    for (size_t i = 0; i < item_num; i++) {
+        TestGatewayData data{};
+        data.gateway = 0;
+        data.th = i;
+        gateway_a.SetData(data);
+    }
+    writer.join();
+    reader.join();
+    stop.store(true);
+    sequencer_thread.join();
+    SPDLOG_INFO("end.");
+
+    // 重启后接着定序
+    disruptor::Sequencer<disruptor::Notebook<TestGatewayData>> sequencer(output);
+    sequencer.Add(gateway_a);
+    sequencer.Add(gateway_b);
+    sequencer.Resume();
+    SPDLOG_INFO("resume, position_a:{}, position_b:{}.", sequencer.Position(0), sequencer.Position(1));
+    return 0;
+}
@@ -1,15 +1,53 @@
 #include "logger.h"
+#include "dirruptor/checksum.h"
+#include "dirruptor/claim.h"
+#include "dirruptor/conflate.h"
+#include "dirruptor/export.h"
+#include "dirruptor/placement.h"
+#include "dirruptor/priority.h"
 #include "dirruptor/spmc.h"
+#include "dirruptor/variant.h"
 #include <iostream>
+#include <thread>
 
 typedef struct {
     char data[128];
     size_t th;
 } TestBufferData;
 
+typedef struct {
+    size_t order_id;
+    double price;
+} TestOrderData;
+
+typedef struct {
+    size_t order_id;
+} TestCancelData;
+
+// 128字节, 固定容量时使用移位布局
+typedef struct {
+    size_t th;
+    char data[120];
+} TestSlotData;
+
+struct TestBufferKey {
+    size_t operator()(const TestBufferData &data) const { return data.th % 16; }
+};
+
 
 int main() {
     bool init_log = ots::utils::create_logger("test.log", "trace", false, false, false);
+    // placement
+    {
+        disruptor::Placement placement;
+        placement.Load();
+        placement.SetCpus(disruptor::Role::kProducer, {0});
+        placement.Validate();
+        // 只固定临时线程, 不影响测试进程
+        std::thread([&placement]() { placement.Apply(disruptor::Role::kProducer, 0); }).join();
+        std::cout << placement.Report();
+    }
+
     // page
     {
         auto page = disruptor::Page("test.store", true);
@@ -54,5 +92,249 @@ int main() {
         SPDLOG_INFO("end.");
     }
 
+    // batch get data
+    {
+        auto notebook = disruptor::Notebook<TestBufferData>();
+        notebook.Attach("test");
+        SPDLOG_INFO("item_num:{}, page_num:{}.", notebook.GetHeader().item_num, notebook.GetHeader().page_num);
+        notebook.SetPrefetch(8);
+        SPDLOG_INFO("start.");
+        size_t idx = 0;
+        size_t sum = 0;
+        while (idx < 1024 * 1024 * 1) {
+            auto end = std::min(notebook.WaitFor(idx), (size_t) 1024 * 1024 * 1);
+            idx = notebook.ForEach(idx, end, [&sum](const size_t &, TestBufferData *ret) {
+                sum += ret->th;
+            });
+        }
+        SPDLOG_INFO("end, sum:{}.", sum);
+    }
+
+    // resume from checkpoint
+    {
+        for (auto run = 0; run < 2; run++) {
+            auto notebook = disruptor::Notebook<TestBufferData>();
+            notebook.Attach("test");
+            notebook.RegisterConsumer("test_resume");
+            notebook.SetCheckpointInterval(1024);
+            size_t idx = notebook.ResumeFromCheckpoint();
+            const size_t end = idx + 1024 * 512;
+            while (idx < end) {
+                idx = notebook.ForEach(idx, std::min(notebook.WaitFor(idx), end), [](const size_t &, TestBufferData *) {});
+            }
+            SPDLOG_INFO("run:{}, stop at:{}.", run, idx);
+        }
+    }
+
+    // conflation
+    {
+        auto writer = disruptor::ConflatingNotebook<TestBufferData, TestBufferKey>();
+        auto reader = disruptor::ConflatingNotebook<TestBufferData, TestBufferKey>();
+        writer.Init("test_conflate", 1024 * 1024, 16, true, true);
+        reader.Init("test_conflate", 1024 * 1024, 16, false, false);
+        for (auto i = 0; i < 1024; i++) {
+            TestBufferData t{};
+            t.th = i;
+            writer.SetData(t);
+        }
+        size_t received = 0;
+        reader.ForEach(0, reader.WaitFor(0), [&received](const size_t &, TestBufferData *) {
+            received++;
+        });
+        SPDLOG_INFO("conflation, received:{}, skipped:{}.", received, reader.Skipped());
+    }
+
+    // compile-time geometry
+    {
+        auto writer = disruptor::Notebook<TestBufferData, 1024 * 1024, 64 * disruptor::Page::MB>();
+        auto reader = disruptor::Notebook<TestBufferData, 1024 * 1024, 64 * disruptor::Page::MB>();
+        writer.Init("test_fixed", 1024 * 1024, true, true);
+        reader.Init("test_fixed", 1024 * 1024, false, false);
+        SPDLOG_INFO("start, page_num:{}.", decltype(writer)::Layout::page_num);
+        for (size_t i = 0; i < 1024 * 1024; i++) {
+            TestBufferData t{};
+            t.th = i;
+            writer.SetData(t);
+        }
+        for (size_t i = 0; i < 1024 * 1024; i++) {
+            reader.WaitFor(i);
+            if (reader.GetData(i)->th != i) {
+                SPDLOG_ERROR("Mismatch at {}.", i);
+            }
+        }
+        SPDLOG_INFO("end.");
+    }
+
+    // compile-time geometry, 2的幂大小的item使用移位和掩码定位, 跨越多个page
+    {
+        using Book = disruptor::Notebook<TestSlotData, 1024 * 1024, 32 * disruptor::Page::MB>;
+        static_assert(Book::Layout::power_of_two && Book::Layout::page_num > 1);
+        auto writer = Book();
+        auto reader = Book();
+        writer.Init("test_shift", 1024 * 1024, true, true);
+        reader.Init("test_shift", 1024 * 1024, false, false);
+        for (size_t i = 0; i < 1024 * 1024; i++) {
+            TestSlotData t{};
+            t.th = i;
+            t.data[119] = (char) i;
+            writer.SetData(t);
+        }
+        size_t error = 0;
+        for (size_t i = 0; i < 1024 * 1024; i++) {
+            reader.WaitFor(i);
+            auto ret = reader.GetData(i);
+            error += ret->th != i || ret->data[119] != (char) i;
+        }
+        SPDLOG_INFO("shift layout, page_num:{}, error:{}.", Book::Layout::page_num, error);
+    }
+
+    // priority lanes
+    {
+        auto writer = disruptor::PriorityNotebook<TestBufferData, 2>();
+        auto reader = disruptor::PriorityNotebook<TestBufferData, 2>();
+        writer.Init("test_priority", 1024 * 1024, true, true);
+        reader.Init("test_priority", 1024 * 1024, false, false);
+        reader.SetStarvationLimit(64);
+        for (auto i = 0; i < 1024; i++) {
+            TestBufferData t{};
+            t.th = i;
+            writer.SetData(1, t);
+            writer.SetData(0, t);
+        }
+        size_t first_bulk = 0;
+        size_t n = 0;
+        reader.Poll([&](const size_t &lane, const size_t &, TestBufferData *) {
+            if (lane == 1 && first_bulk == 0) {
+                first_bulk = n;
+            }
+            n++;
+        });
+        SPDLOG_INFO("priority, read:{}, first_bulk:{}, forced:{}.", n, first_bulk, reader.Forced(1));
+    }
+
+    // checksum
+    {
+        auto writer = disruptor::ChecksumNotebook<TestBufferData>();
+        auto reader = disruptor::ChecksumNotebook<TestBufferData>();
+        writer.Init("test_checksum", 1024 * 1024, true, true);
+        reader.Attach("test_checksum");
+        for (size_t i = 0; i < 1024; i++) {
+            TestBufferData t{};
+            t.th = i;
+            writer.SetData(t);
+        }
+        writer.GetNotebook().GetData(100)->th = 0;//模拟损坏
+        size_t bad = 0;
+        for (auto i = 0; i < 1024; i++) {
+            bad += !reader.Verify(i);
+        }
+        SPDLOG_INFO("checksum, crc32c(123456789):{:#x}, bad:{}.", disruptor::Crc32c("123456789", 9), bad);
+    }
+
+    // columnar export
+    {
+        auto writer = disruptor::Notebook<TestBufferData>();
+        writer.Init("test_export", 1024 * 1024, true, true);
+        for (auto i = 0; i < 1024 * 1024; i++) {
+            TestBufferData t{};
+            t.th = i;
+            writer.SetData(t);
+        }
+        disruptor::Journal journal;
+        journal.Open("test_export");
+        disruptor::ColumnExporter exporter;
+        exporter.AddColumn("th", offsetof(TestBufferData, th), disruptor::ColumnType::kUInt64, true);
+        exporter.Export(journal, "test_export");
+
+        disruptor::ColumnReader reader;
+        reader.Open("test_export_th.col");
+        std::vector<uint64_t> values;
+        size_t error = 0;
+        for (size_t b = 0; b < reader.GetHeader().block_num; b++) {
+            reader.ReadBlock(b, values);
+            for (size_t i = 0; i < values.size(); i++) {
+                error += values[i] != b * reader.GetHeader().block_size + i;
+            }
+        }
+        SPDLOG_INFO("export, blocks:{}, last max:{}, error:{}.", reader.GetHeader().block_num,
+                    reader.GetStats(reader.GetHeader().block_num - 1).max, error);
+    }
+
+    // numa
+    {
+        auto notebook = disruptor::Notebook<TestBufferData>();
+        notebook.Init("test_numa", 1024 * 1024, true, true);
+        notebook.BindPages(disruptor::kMemInterleave, {0});
+        for (auto i = 0; i < 1024 * 64; i++) {
+            TestBufferData t{};
+            t.th = i;
+            notebook.SetData(t);
+        }
+        std::cout << notebook.ResidencyReport();
+    }
+
+    // variant
+    {
+        using Message = disruptor::Variant<TestBufferData, TestOrderData, TestCancelData>;
+        auto writer = disruptor::Notebook<Message>();
+        auto reader = disruptor::Notebook<Message>();
+        writer.Init("test_variant", 1024 * 1024, true, true);
+        reader.Init("test_variant", 1024 * 1024, false, false);
+        for (size_t i = 0; i < 1024; i++) {
+            if (i % 2 == 0) {
+                writer.OpenData()->Emplace<TestOrderData>(i, 100.0 + i);
+            } else {
+                writer.OpenData()->Emplace<TestCancelData>(i - 1);
+            }
+            writer.Commit();
+        }
+        size_t orders = 0, cancels = 0;
+        auto handler = disruptor::Overload{
+                [&](const TestBufferData &) {},
+                [&](const TestOrderData &) { orders++; },
+                [&](const TestCancelData &) { cancels++; },
+        };
+        reader.ForEach(0, reader.WaitFor(0), [&handler](const size_t &, Message *ret) {
+            ret->Dispatch(handler);
+        });
+        SPDLOG_INFO("variant, slot:{}, orders:{}, cancels:{}.", sizeof(Message), orders, cancels);
+    }
+
+    // claim guard
+    {
+        auto writer = disruptor::Notebook<TestOrderData>();
+        auto reader = disruptor::Notebook<TestOrderData>();
+        writer.Init("test_claim", 1024 * 1024, true, true);
+        reader.Init("test_claim", 1024 * 1024, false, false);
+        for (size_t i = 0; i < 512; i++) {
+            auto claim = disruptor::Emplace(writer, i, 100.0 + i);
+        }
+        {
+            disruptor::BatchClaim batch(writer, 512);
+            for (size_t i = 0; i < batch.Size(); i++) {
+                batch.Emplace(i, batch.First() + i, 100.0 + batch.First() + i);
+            }
+        }
+        {
+            disruptor::Claim claim(writer);
+            claim->order_id = 0;
+            claim.Cancel();
+        }
+        size_t error = 0;
+        reader.ForEach(0, reader.WaitFor(0), [&error](const size_t &i, TestOrderData *ret) {
+            error += ret->order_id != i || ret->price != 100.0 + i;
+        });
+        SPDLOG_INFO("claim, cursor:{}, error:{}.", reader.GetCursor(), error);
+
+        // 空的批次和超过容量的批次都不申请也不提交, cursor不变
+        const size_t cursor = writer.GetCursor();
+        {
+            disruptor::BatchClaim empty(writer, 0);
+            disruptor::BatchClaim oversized(writer, 1024 * 1024 + 1);
+            SPDLOG_INFO("claim, empty size:{}, oversized size:{}.", empty.Size(), oversized.Size());
+        }
+        SPDLOG_INFO("claim, cursor before:{}, after:{}.", cursor, writer.GetCursor());
+    }
+
     return 0;
 }
@@ -0,0 +1,55 @@
+#include "logger.h"
+#include "dirruptor/timer.h"
+#include <iostream>
+#include <random>
+
+typedef struct {
+    int64_t due;
+    size_t th;
+} TestTimerData;
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "info", false, false, false);
+    const size_t item_num = 1024 * 1024;
+    const int64_t tick_ns = 1000;
+
+    auto writer = disruptor::Notebook<TestTimerData>();
+    writer.Init("test_timer", item_num, true, true);
+    auto reader = disruptor::Notebook<TestTimerData>();
+    reader.Init("test_timer", item_num, false, false);
+
+    // 按模拟时间驱动, 到期时间覆盖所有层
+    disruptor::TimerWheel<TestTimerData, disruptor::Notebook<TestTimerData>> wheel(writer, tick_ns, 0);
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> timer_ids;
+    for (size_t i = 0; i < item_num / 2; i++) {
+        TestTimerData data{};
+        data.due = (int64_t) (random() % (1ull << (6 + i % 28))) * tick_ns;
+        data.th = i;
+        timer_ids.push_back(wheel.Schedule(data, data.due));
+    }
+    size_t cancelled = 0;
+    for (size_t i = 0; i < timer_ids.size(); i += 3) {
+        cancelled += wheel.Cancel(timer_ids[i]);
+    }
+    SPDLOG_INFO("start, scheduled:{}, cancelled:{}.", wheel.Size(), cancelled);
+
+    size_t published = 0;
+    size_t error = 0;
+    int64_t last_due = 0;
+    for (int64_t now = 0; wheel.Size() > 0; now += random() % (1ull << 20) * tick_ns) {
+        const size_t n = wheel.Advance(now);
+        for (size_t idx = published; idx < published + n; idx++) {
+            auto data = reader.GetData(idx);
+            // 不早于到期时间, 按到期时间顺序写入, 已取消的不写入
+            if (data->due > now || data->due / tick_ns < last_due / tick_ns || data->th % 3 == 0) {
+                error++;
+            }
+            last_due = data->due;
+        }
+        published += n;
+    }
+    SPDLOG_INFO("end, published:{}, error:{}.", published, error);
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "logger.h"
+#include "dirruptor/topic.h"
+#include <iostream>
+#include <sys/wait.h>
+
+typedef struct {
+    char data[128];
+    size_t th;
+} TestBufferData;
+
+typedef struct {
+    double price;
+    size_t volume;
+} TestQuoteData;
+
+
+int main() {
+    bool init_log = ots::utils::create_logger("test.log", "trace", false, false, false);
+
+    // writer, 一个共享内存中创建多个topic
+    {
+        auto directory = disruptor::TopicDirectory();
+        directory.Init("test", 256 * disruptor::Page::MB, true, true);
+        for (auto i = 0; i < 200; i++) {
+            auto topic = directory.Create<TestQuoteData>("quote_" + std::to_string(i), 1024 * 16);
+            for (auto j = 0; j < 1024; j++) {
+                topic.SetData(TestQuoteData{(double) i, (size_t) j});
+            }
+        }
+        auto topic = directory.Create<TestBufferData>("buffer", 1024 * 1024);
+        for (auto i = 0; i < 1024; i++) {
+            auto tmp = topic.OpenData();
+            tmp->th = i;
+            topic.Commit();
+        }
+    }
+
+    // reader, 只根据路径加载, 按名称订阅
+    {
+        auto directory = disruptor::TopicDirectory();
+        directory.Attach("test");
+        SPDLOG_INFO("topic num:{}.", directory.List().size());
+
+        auto quote = directory.Open<TestQuoteData>("quote_199");
+        auto end = quote.WaitFor(0);
+        SPDLOG_INFO("quote_199, cursor:{}, last price:{}, volume:{}.", end, quote.GetData(end - 1)->price, quote.GetData(end - 1)->volume);
+
+        auto buffer = directory.Open<TestBufferData>("buffer");
+        SPDLOG_INFO("buffer, cursor:{}, last th:{}.", buffer.WaitFor(0), buffer.GetData(buffer.WaitFor(0) - 1)->th);
+
+        auto wrong = directory.Open<TestBufferData>("quote_0");
+        SPDLOG_INFO("open with wrong type, valid:{}.", wrong.Valid());
+    }
+
+    // 多个进程同时创建同名topic, 只分配一次
+    {
+        auto directory = disruptor::TopicDirectory();
+        directory.Init("test_race", 64 * disruptor::Page::MB, true, true);
+        for (auto p = 0; p < 4; p++) {
+            if (fork() == 0) {
+                auto child = disruptor::TopicDirectory();
+                child.Attach("test_race", true);
+                for (auto i = 0; i < 64; i++) {
+                    child.Create<TestQuoteData>("race_" + std::to_string(i), 1024);
+                }
+                _exit(0);
+            }
+        }
+        while (wait(nullptr) > 0) {
+        }
+        SPDLOG_INFO("concurrent create, topic num:{}.", directory.List().size());
+    }
+    return 0;
+}